@@ -227,9 +227,27 @@ BRDBoard::BRDBoard(const BRDFileBase * const boardFile)
 	sort(begin(components_), end(components_), [](const std::shared_ptr<Component> &lhs, const std::shared_ptr<Component> &rhs) {
 		return lhs->name < rhs->name;
 	});
+
+	// Exact name lookups, pins of a net are already in Net::pins
+	net_index_.reserve(nets_.size());
+	for (size_t i = 0; i < nets_.size(); i++) net_index_.emplace(nets_[i]->name, i);
+	component_index_.reserve(components_.size());
+	for (size_t i = 0; i < components_.size(); i++) component_index_.emplace(components_[i]->name, i);
+
+	// Elements seen from each side, so that drawing and hit testing skip the other side
+	for (int side = kBoardSideTop; side <= kBoardSideBottom; side++) {
+		for (uint32_t i = 0; i < pins_.size(); i++)
+			if (pins_[i]->board_side == side || pins_[i]->board_side == kBoardSideBoth) pins_on_side_[side].push_back(i);
+		for (uint32_t i = 0; i < components_.size(); i++)
+			if (components_[i]->board_side == side || components_[i]->board_side == kBoardSideBoth)
+				components_on_side_[side].push_back(i);
+	}
 }
 
-BRDBoard::~BRDBoard() {}
+BRDBoard::~BRDBoard() {
+	// Components and their pins point to each other, break the cycles or the board is never freed
+	for (auto &component : components_) component->pins.clear();
+}
 
 SharedVector<Component> &BRDBoard::Components() {
 	return components_;
@@ -251,6 +269,24 @@ std::vector<std::pair<Point, Point>> &BRDBoard::OutlineSegments() {
 	return outline_segments_;
 }
 
+int BRDBoard::NetIndex(const std::string &name) {
+	auto it = net_index_.find(name);
+	return it == net_index_.end() ? -1 : it->second;
+}
+
+int BRDBoard::ComponentIndex(const std::string &name) {
+	auto it = component_index_.find(name);
+	return it == component_index_.end() ? -1 : it->second;
+}
+
+const std::vector<uint32_t> &BRDBoard::PinsOnSide(int side) {
+	return pins_on_side_[side];
+}
+
+const std::vector<uint32_t> &BRDBoard::ComponentsOnSide(int side) {
+	return components_on_side_[side];
+}
+
 Board::EBoardType BRDBoard::BoardType() {
 	return kBoardTypeBRD;
 }
@@ -4,6 +4,7 @@
 
 #include <memory>
 #include <cstring>
+#include <unordered_map>
 #include <vector>
 
 class BRDBoard : public Board {
@@ -21,6 +22,12 @@ class BRDBoard : public Board {
 	SharedVector<Point> &OutlinePoints();
 	std::vector<std::pair<Point, Point>> &OutlineSegments();
 
+	int NetIndex(const std::string &name);
+	int ComponentIndex(const std::string &name);
+
+	const std::vector<uint32_t> &PinsOnSide(int side);
+	const std::vector<uint32_t> &ComponentsOnSide(int side);
+
   private:
 	static const std::string kNetUnconnectedPrefix;
 	static const std::string kComponentDummyName;
@@ -30,4 +37,10 @@ class BRDBoard : public Board {
 	SharedVector<Pin> pins_;
 	SharedVector<Point> outline_points_;
 	std::vector<std::pair<Point, Point>> outline_segments_;
+
+	std::unordered_map<std::string, int> net_index_;
+	std::unordered_map<std::string, int> component_index_; // first of the parts sharing a name
+
+	std::vector<uint32_t> pins_on_side_[2];
+	std::vector<uint32_t> components_on_side_[2];
 };
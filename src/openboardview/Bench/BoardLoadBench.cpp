@@ -0,0 +1,403 @@
+/*
+ * Headless board loading benchmark: reads every board file of a directory, parses it, builds the
+ * board and its derived data (outline, part hulls, statistics) the way BoardView::LoadBoard does,
+ * without a window. Each file is loaded several times, stage times are medians over the runs.
+ *
+ * Output, one row per file: stage times, pins/s, operator new calls and bytes of one run and the
+ * peak resident set size while loading the file (on Linux, elsewhere the peak of the process so far).
+ * A per format summary goes to stderr.
+ *
+ * The keys of the encrypted formats (FZ, CAE, XZZ) are read from the FZKey, CAEKey and XZZPCBKey
+ * entries of the configuration file given with -c, as in the viewer's obv.conf.
+ *
+ * Usage: obv-bench [-r runs] [-c <config file>] [--json] <directory or file>...
+ */
+#define SDL_MAIN_HANDLED
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <climits>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <map>
+#include <new>
+#include <string>
+#include <vector>
+
+#ifdef _WIN32
+#include <windows.h>
+#include <psapi.h>
+#else
+#include <sys/resource.h>
+#endif
+#ifdef __GLIBC__
+#include <malloc.h>
+#endif
+
+#include "BRDBoard.h"
+#include "BoardStats.h"
+#include "FileFormats/BoardFormat.h"
+#include "GUI/Config.h"
+#include "confparse.h"
+#include "utils.h"
+#include "vectorhulls.h"
+
+// Allocation counters, every operator new of the process goes through here
+static std::atomic<size_t> allocCount{0}, allocBytes{0};
+
+// Not inlined, GCC would otherwise report free() in operator delete as mismatched with operator new
+#if defined(__GNUC__)
+#define NOINLINE __attribute__((noinline))
+#elif defined(_MSC_VER)
+#define NOINLINE __declspec(noinline)
+#else
+#define NOINLINE
+#endif
+
+NOINLINE void *operator new(size_t size) {
+	allocCount.fetch_add(1, std::memory_order_relaxed);
+	allocBytes.fetch_add(size, std::memory_order_relaxed);
+	if (void *p = malloc(size ? size : 1)) return p;
+	throw std::bad_alloc();
+}
+
+NOINLINE void operator delete(void *p) noexcept {
+	free(p);
+}
+
+NOINLINE void operator delete(void *p, size_t) noexcept {
+	free(p);
+}
+
+// Peak resident set size in KiB
+static size_t peakRss() {
+#ifdef _WIN32
+	PROCESS_MEMORY_COUNTERS pmc;
+	if (GetProcessMemoryInfo(GetCurrentProcess(), &pmc, sizeof(pmc))) return pmc.PeakWorkingSetSize / 1024;
+	return 0;
+#elif defined(__linux__)
+	if (FILE *f = fopen("/proc/self/status", "r")) {
+		char line[128];
+		size_t kb = 0;
+		while (fgets(line, sizeof(line), f))
+			if (sscanf(line, "VmHWM: %zu kB", &kb) == 1) break;
+		fclose(f);
+		if (kb) return kb;
+	}
+	struct rusage usage;
+	getrusage(RUSAGE_SELF, &usage);
+	return usage.ru_maxrss;
+#else
+	struct rusage usage;
+	getrusage(RUSAGE_SELF, &usage);
+	return usage.ru_maxrss / 1024; // bytes on macOS
+#endif
+}
+
+// Start measuring the peak from the current usage, Linux only
+static void resetPeakRss() {
+#ifdef __linux__
+#ifdef __GLIBC__
+	malloc_trim(0); // give the previous file's memory back, or it still counts as resident
+#endif
+	if (FILE *f = fopen("/proc/self/clear_refs", "w")) {
+		fputs("5", f);
+		fclose(f);
+	}
+#endif
+}
+
+enum Stage { kRead, kDetect, kParse, kBoard, kHulls, kStats, kStageCount };
+static const char *stageNames[kStageCount] = {"read", "detect", "parse", "board", "hulls", "stats"};
+
+struct Result {
+	std::string file, format, error;
+	size_t bytes = 0;
+	unsigned int parts = 0, pins = 0, nets = 0;
+	double ms[kStageCount] = {};
+	double totalMs = 0.0, minTotalMs = 0.0;
+	size_t allocs = 0, allocatedBytes = 0, peakRssKb = 0;
+
+	double pinsPerSecond() const {
+		return totalMs > 0.0 ? pins / (totalMs / 1000.0) : 0.0;
+	}
+};
+
+static double median(std::vector<double> v) {
+	std::sort(v.begin(), v.end());
+	size_t n = v.size();
+	return n % 2 ? v[n / 2] : (v[n / 2 - 1] + v[n / 2]) / 2.0;
+}
+
+// Outline of the board when the file has none, as BoardView::LoadBoard does
+static void generateOutline(BRDFileBase *file) {
+	if (file->outline_segments.size() >= 3 || file->format.size() >= 3) return;
+	int minx = INT_MAX, maxx = INT_MIN, miny = INT_MAX, maxy = INT_MIN;
+	for (auto &pin : file->pins) {
+		minx = std::min(minx, pin.pos.x);
+		maxx = std::max(maxx, pin.pos.x);
+		miny = std::min(miny, pin.pos.y);
+		maxy = std::max(maxy, pin.pos.y);
+	}
+	int margin = 200;
+	file->format.push_back({minx - margin, miny - margin});
+	file->format.push_back({maxx + margin, miny - margin});
+	file->format.push_back({maxx + margin, maxy + margin});
+	file->format.push_back({minx - margin, maxy + margin});
+	file->format.push_back({minx - margin, miny - margin});
+}
+
+// Convex hull and minimal bounding box of the parts, BoardView computes them while drawing the parts
+static void partHulls(Board *board) {
+	std::vector<ImVec2> pva;
+	for (auto &part : board->Components()) {
+		if (part->pins.size() < 4) continue;
+		pva.clear();
+		for (auto &pin : part->pins) pva.push_back({pin->position.x, pin->position.y});
+		part->hull = VHConvexHull(pva);
+		if (!part->hull.empty()) part->outline = VHMBBCalculate(part->hull, 1.0);
+	}
+}
+
+static Result bench(const filesystem::path &path, int runs, const BoardFileKeys &keys, BoardStats &stats) {
+	using Clock = std::chrono::steady_clock;
+	Result result;
+	result.file = path.string();
+	std::vector<double> times[kStageCount], totals;
+
+	resetPeakRss();
+	for (int run = 0; run < runs; run++) {
+		Clock::time_point t[kStageCount + 1];
+		allocCount = 0;
+		allocBytes = 0;
+
+		t[kRead] = Clock::now();
+		std::vector<char> buffer = file_as_buffer(path, result.error);
+		if (buffer.empty()) {
+			if (result.error.empty()) result.error = "empty file";
+			return result;
+		}
+		result.bytes = buffer.size();
+
+		t[kDetect]         = Clock::now();
+		BoardFormat format = detectBoardFormat(path, buffer, keys);
+		if (!format.open) {
+			result.error = "unrecognized format";
+			return result;
+		}
+		result.format = format.name;
+
+		t[kParse]         = Clock::now();
+		BRDFileBase *file = format.open(buffer);
+		if (!file || !file->valid) {
+			result.error = file && !file->error_msg.empty() ? file->error_msg : "parse error";
+			delete file;
+			return result;
+		}
+
+		t[kBoard] = Clock::now();
+		generateOutline(file);
+		BRDBoard *board = new BRDBoard(file);
+
+		t[kHulls] = Clock::now();
+		partHulls(board);
+
+		t[kStats] = Clock::now();
+		stats.compute(board);
+		stats.clear(); // waits for the worker
+		t[kStageCount] = Clock::now();
+
+		result.allocs         = allocCount;
+		result.allocatedBytes = allocBytes;
+		result.parts          = board->Components().size();
+		result.pins           = board->Pins().size();
+		result.nets           = board->Nets().size();
+		delete board;
+		delete file;
+
+		for (int s = 0; s < kStageCount; s++)
+			times[s].push_back(std::chrono::duration<double, std::milli>(t[s + 1] - t[s]).count());
+		totals.push_back(std::chrono::duration<double, std::milli>(t[kStageCount] - t[kRead]).count());
+	}
+	result.peakRssKb = peakRss();
+
+	for (int s = 0; s < kStageCount; s++) result.ms[s] = median(times[s]);
+	result.totalMs    = median(totals);
+	result.minTotalMs = *std::min_element(totals.begin(), totals.end());
+	return result;
+}
+
+static void printCsvHeader() {
+	printf("file,format,bytes,parts,pins,nets");
+	for (auto name : stageNames) printf(",%s_ms", name);
+	printf(",total_ms,min_total_ms,pins_per_s,allocs,alloc_bytes,peak_rss_kb,error\n");
+}
+
+// Quoted when it contains a separator or a quote
+static void printCsvField(const std::string &s) {
+	if (s.find_first_of(",\"\n") == std::string::npos) {
+		fputs(s.c_str(), stdout);
+		return;
+	}
+	putchar('"');
+	for (char c : s) {
+		if (c == '"') putchar('"');
+		putchar(c);
+	}
+	putchar('"');
+}
+
+static void printCsv(const Result &r) {
+	printCsvField(r.file);
+	printf(",%s,%zu,%u,%u,%u", r.format.c_str(), r.bytes, r.parts, r.pins, r.nets);
+	for (double ms : r.ms) printf(",%.3f", ms);
+	printf(",%.3f,%.3f,%.0f,%zu,%zu,%zu,", r.totalMs, r.minTotalMs, r.pinsPerSecond(), r.allocs, r.allocatedBytes, r.peakRssKb);
+	printCsvField(r.error);
+	putchar('\n');
+}
+
+static void printJsonString(const std::string &s) {
+	putchar('"');
+	for (unsigned char c : s) {
+		if (c == '"' || c == '\\')
+			printf("\\%c", c);
+		else if (c < 0x20)
+			printf("\\u%04x", c);
+		else
+			putchar(c);
+	}
+	putchar('"');
+}
+
+static void printJson(const Result &r, bool first) {
+	printf("%s\n    {\"file\":", first ? "" : ",");
+	printJsonString(r.file);
+	printf(",\"format\":");
+	printJsonString(r.format);
+	printf(",\"bytes\":%zu,\"parts\":%u,\"pins\":%u,\"nets\":%u,\"ms\":{", r.bytes, r.parts, r.pins, r.nets);
+	for (int s = 0; s < kStageCount; s++) printf("%s\"%s\":%.3f", s ? "," : "", stageNames[s], r.ms[s]);
+	printf("},\"total_ms\":%.3f,\"min_total_ms\":%.3f,\"pins_per_s\":%.0f", r.totalMs, r.minTotalMs, r.pinsPerSecond());
+	printf(",\"allocs\":%zu,\"alloc_bytes\":%zu,\"peak_rss_kb\":%zu", r.allocs, r.allocatedBytes, r.peakRssKb);
+	if (!r.error.empty()) {
+		printf(",\"error\":");
+		printJsonString(r.error);
+	}
+	putchar('}');
+}
+
+// Keys as the viewer reads them from its configuration
+static bool readKeys(const filesystem::path &path, BoardFileKeys &keys) {
+	if (!filesystem::exists(path)) return false; // Confparse would create it
+	Confparse obvconfig;
+	if (obvconfig.Load(path)) return false;
+
+	Config config;
+	config.SetFZKey(obvconfig.ParseStr("FZKey", ""));
+	config.SetCAEKey(obvconfig.ParseStr("CAEKey", ""));
+	config.SetXZZPCBKey(obvconfig.ParseStr("XZZPCBKey", ""));
+	keys.fz  = config.FZKey;
+	keys.cae = config.CAEKey;
+	keys.xzz = config.XZZPCBKey;
+	return true;
+}
+
+int main(int argc, char **argv) {
+	int runs  = 5;
+	bool json = false;
+	BoardFileKeys keys;
+	std::vector<filesystem::path> files;
+
+	for (int i = 1; i < argc; i++) {
+		if (!strcmp(argv[i], "-r") && i + 1 < argc) {
+			runs = std::max(1, atoi(argv[++i]));
+		} else if (!strcmp(argv[i], "-c") && i + 1 < argc) {
+			if (!readKeys(argv[++i], keys)) {
+				fprintf(stderr, "Cannot read configuration file %s\n", argv[i]);
+				return 1;
+			}
+		} else if (!strcmp(argv[i], "--json")) {
+			json = true;
+		} else if (filesystem::is_directory(argv[i])) {
+			std::vector<filesystem::path> dir;
+			for (auto &entry : filesystem::recursive_directory_iterator(argv[i])) {
+				// ASCFile reads these along with pins.asc, the board is loaded once
+				auto name = entry.path().filename().string();
+				if (compare_string_insensitive(name, "format.asc") || compare_string_insensitive(name, "nails.asc")) continue;
+				if (entry.is_regular_file()) dir.push_back(entry.path());
+			}
+			std::sort(dir.begin(), dir.end());
+			files.insert(files.end(), dir.begin(), dir.end());
+		} else if (filesystem::exists(argv[i])) {
+			files.push_back(argv[i]);
+		} else {
+			fprintf(stderr, "Usage: %s [-r runs] [-c <config file>] [--json] <directory or file>...\n", argv[0]);
+			return 1;
+		}
+	}
+	if (files.empty()) {
+		fprintf(stderr, "Usage: %s [-r runs] [-c <config file>] [--json] <directory or file>...\n", argv[0]);
+		return 1;
+	}
+
+	struct Summary {
+		unsigned int files = 0;
+		size_t pins        = 0;
+		double ms          = 0.0;
+	};
+	std::map<std::string, Summary> formats;
+
+	if (json)
+		printf("{\"runs\":%d,\"files\":[", runs);
+	else
+		printCsvHeader();
+
+	BoardStats stats; // its worker thread starts once, not in the timed stage
+	bool first = true;
+	for (auto &path : files) {
+		Result r = bench(path, runs, keys, stats);
+		if (r.format.empty()) { // not a board, annotations database, PDF...
+			fprintf(stderr, "Skipped %s: %s\n", r.file.c_str(), r.error.c_str());
+			continue;
+		}
+		if (json)
+			printJson(r, first);
+		else
+			printCsv(r);
+		first = false;
+		fflush(stdout);
+
+		if (!r.error.empty()) continue;
+		auto &s = formats[r.format];
+		s.files++;
+		s.pins += r.pins;
+		s.ms += r.totalMs;
+	}
+
+	if (json) {
+		printf("\n  ],\n  \"formats\":{");
+		first = true;
+		for (auto &f : formats) {
+			printf("%s\n    ", first ? "" : ",");
+			printJsonString(f.first);
+			printf(":{\"files\":%u,\"pins\":%zu,\"total_ms\":%.3f,\"pins_per_s\":%.0f}",
+			       f.second.files,
+			       f.second.pins,
+			       f.second.ms,
+			       f.second.ms > 0.0 ? f.second.pins / (f.second.ms / 1000.0) : 0.0);
+			first = false;
+		}
+		printf("\n  }\n}\n");
+	}
+
+	for (auto &f : formats)
+		fprintf(stderr,
+		        "%-12s %4u files %10zu pins %10.1f ms %12.0f pins/s\n",
+		        f.first.c_str(),
+		        f.second.files,
+		        f.second.pins,
+		        f.second.ms,
+		        f.second.ms > 0.0 ? f.second.pins / (f.second.ms / 1000.0) : 0.0);
+	return 0;
+}
@@ -0,0 +1,113 @@
+/*
+ * Micro-benchmark of the edit distance kernels and SpellCorrector::suggest over a synthetic
+ * net name dictionary (power rails, DDR/PCIe/USB buses, test points...).
+ *
+ * Usage: obv-bench-levenshtein [words] [queries]
+ */
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <random>
+#include <string>
+#include <vector>
+
+#include "Levenshtein.h"
+#include "SpellCorrector.h"
+
+static std::vector<std::string> netNames(size_t count, std::mt19937 &rng) {
+	static const char *rails[]   = {"PP3V3_S5", "PP1V8_S0", "PP5V_S3", "PPVCC_CPU", "PPVCC_GPU", "PP1V1_S0SW", "PPBUS_G3H", "PP0V9_SLPS2R"};
+	static const char *buses[]   = {"DDR_DQ", "DDR_DQS_P", "DDR_DQS_N", "DDR_CA", "PCIE_TX_P", "PCIE_RX_N", "USB_C_DP", "DP_AUX_P"};
+	static const char *signals[] = {"I2C_SCL", "I2C_SDA", "SPI_CLK", "SPI_MOSI", "SMC_RESET_L", "PM_SLP_S3_L", "LCD_BKLT_EN", "FAN_TACH"};
+	std::vector<std::string> names;
+	names.reserve(count);
+	while (names.size() < count) {
+		unsigned int n = rng() % 256;
+		switch (rng() % 5) {
+			case 0: names.push_back(rails[rng() % 8] + std::string(rng() % 2 ? "" : "_R") + std::to_string(n % 8)); break;
+			case 1: names.push_back(buses[rng() % 8] + std::to_string(n) + (rng() % 2 ? "_A" : "_B")); break;
+			case 2: names.push_back(signals[rng() % 8] + std::string("_") + std::to_string(n)); break;
+			case 3: names.push_back("TP" + std::to_string(rng() % 10000)); break;
+			default: names.push_back("NET" + std::to_string(rng() % 100000)); break;
+		}
+	}
+	return names;
+}
+
+// What a user types: a prefix of a name with a typo
+static std::string query(const std::string &name, std::mt19937 &rng) {
+	std::string q = name.substr(0, 3 + rng() % (name.size() - 2));
+	size_t pos    = rng() % q.size();
+	switch (rng() % 3) {
+		case 0: q[pos] = 'A' + rng() % 26; break;
+		case 1: q.erase(pos, 1); break;
+		default: q.insert(pos, 1, '_'); break;
+	}
+	return q;
+}
+
+template <class F> static double nsPer(size_t count, F f) {
+	auto start = std::chrono::steady_clock::now();
+	f();
+	std::chrono::duration<double, std::nano> elapsed = std::chrono::steady_clock::now() - start;
+	return elapsed.count() / count;
+}
+
+int main(int argc, char **argv) {
+	size_t words   = argc > 1 ? strtoul(argv[1], nullptr, 10) : 30000;
+	size_t queries = argc > 2 ? strtoul(argv[2], nullptr, 10) : 200;
+
+	std::mt19937 rng(1);
+	auto dictionary = netNames(words, rng);
+	std::vector<std::string> typed;
+	for (size_t i = 0; i < queries; i++) typed.push_back(query(dictionary[rng() % words], rng));
+
+	size_t pairs      = words * queries;
+	unsigned long sum = 0; // keeps the compiler from dropping the loops
+	printf("%zu words, %zu queries\n", words, queries);
+
+	double dp = nsPer(pairs, [&] {
+		for (auto &q : typed)
+			for (auto &w : dictionary) sum += levenshtein_dp(q, w);
+	});
+	printf("levenshtein_dp        %8.1f ns/pair\n", dp);
+
+	double myers = nsPer(pairs, [&] {
+		for (auto &q : typed)
+			for (auto &w : dictionary) sum += levenshtein_distance(q, w);
+	});
+	printf("levenshtein_distance  %8.1f ns/pair (%.1fx)\n", myers, dp / myers);
+
+	double bounded = nsPer(pairs, [&] {
+		for (auto &q : typed)
+			for (auto &w : dictionary) sum += levenshtein_bounded(q, w, 3);
+	});
+	printf("levenshtein_bounded 3 %8.1f ns/pair (%.1fx)\n", bounded, dp / bounded);
+
+	SpellCorrector sc;
+	double build = nsPer(1, [&] { sc.setDictionary(dictionary); });
+	printf("setDictionary         %8.2f ms\n", build / 1e6);
+
+	// Separate correctors, each query is answered from the cache after the first time
+	SpellCorrector scDP;
+	scDP.bitParallel = false;
+	scDP.setDictionary(dictionary);
+
+	double suggestDP = nsPer(queries, [&] {
+		for (auto &q : typed) sum += scDP.suggest(q, 30).size();
+	});
+	printf("suggest DP walk       %8.1f us/query\n", suggestDP / 1e3);
+
+	double suggest = nsPer(queries, [&] {
+		for (auto &q : typed) sum += sc.suggest(q, 30).size();
+	});
+	printf("suggest               %8.1f us/query (%.1fx)\n", suggest / 1e3, suggestDP / suggest);
+
+	for (auto &q : typed) {
+		if (sc.suggest(q, 30) != scDP.suggest(q, 30)) {
+			printf("suggestions differ for %s\n", q.c_str());
+			return 1;
+		}
+	}
+
+	return sum == 0; // never true, distances are not all 0
+}
@@ -0,0 +1,657 @@
+/*
+ * Synthetic board generator for scaling tests, customer boards cannot be shared.
+ *
+ * Lays out BGAs, ICs, connectors and passives to reach a pin count, with many small nets, a few
+ * giant power nets and an outline made of lines and arcs (-a bumps per edge). The board is built
+ * in the parser data structures (BRDFileBase) and written as BRD, BRD2, BVR3, GenCAD and ASC.
+ * With --check each file is read back through detectBoardFormat() and its parser.
+ *
+ * Usage: obv-gen-board [-n pins] [-c parts] [-b bgas] [-g grid] [-p power nets] [-a arcs] [-s seed]
+ *                      [-f brd,brd2,bvr3,gencad,asc] [--check] <output directory>
+ * e.g. 10k, 100k and 1M pins boards for obv-bench:
+ *        for n in 10000 100000 1000000; do obv-gen-board -n $n boards; done
+ */
+#define SDL_MAIN_HANDLED
+
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <deque>
+#include <map>
+#include <random>
+#include <string>
+#include <vector>
+
+#include "FileFormats/BRDFileBase.h"
+#include "FileFormats/BoardFormat.h"
+#include "utils.h"
+
+#ifndef M_PI
+#define M_PI 3.14159265358979323846
+#endif
+
+struct Options {
+	unsigned int pins      = 10000;
+	unsigned int parts     = 0; // 0: about one part per 3 pins
+	unsigned int bgas      = 0; // 0: one per 20k pins, at least one
+	unsigned int bgaGrid   = 40;
+	unsigned int powerNets = 8;
+	unsigned int arcs      = 32; // per outline edge
+	unsigned int seed      = 1;
+	std::string formats    = "brd,brd2,bvr3,gencad,asc";
+	bool check             = false;
+};
+
+// Pin layout shared by parts, GenCAD shapes
+struct Footprint {
+	std::string name;
+	BRDPartType type = BRDPartType::SMD;
+	double radius    = 0.5;
+	std::vector<BRDPoint> pins{}; // relative to the part origin
+	std::vector<std::string> names{};
+	BRDPoint min{}, max{}; // extent of the pins
+};
+
+// Outline element, arcs go counterclockwise from start to end
+struct OutlineEdge {
+	bool arc;
+	BRDPoint start, end, center;
+};
+
+// Generated board, in the structures the parsers fill so that writers and checks read the same data
+class SyntheticBoard : public BRDFileBase {
+public:
+	std::deque<Footprint> footprints; // deque: pins point to the pin names
+	std::vector<unsigned int> partFootprint;
+	std::vector<BRDPoint> partOrigin;
+	std::deque<std::string> names; // part and net names the pins and parts point to
+	std::vector<const char *> nets;
+	std::vector<unsigned int> pinNet; // index in nets of each pin
+	std::vector<OutlineEdge> outline;
+	BRDPoint max; // top-right corner, the bottom-left one is 0, 0
+
+	void generate(const Options &options);
+	// Outline as segments, arcs approximated as the parsers do
+	std::vector<std::pair<BRDPoint, BRDPoint>> segments();
+
+private:
+	std::mt19937 m_rng;
+	std::map<std::string, unsigned int> m_footprintIndex;
+
+	unsigned int footprint(unsigned int pins, bool connector);
+	unsigned int addFootprint(Footprint fp);
+	void place(unsigned int fp, BRDPartMountingSide side);
+	void connect(const Options &options);
+	void generateOutline(int width, int height, unsigned int arcs);
+
+	double uniform() {
+		return std::uniform_real_distribution<double>()(m_rng);
+	}
+};
+
+// JEDEC ball row names, A to Y without I, O, Q, S, X, Z then AA, AB...
+static std::string bgaRow(unsigned int row) {
+	static const char letters[] = "ABCDEFGHJKLMNPRTUVWY";
+	std::string s;
+	if (row >= 20) s += letters[row / 20 - 1];
+	s += letters[row % 20];
+	return s;
+}
+
+unsigned int SyntheticBoard::addFootprint(Footprint fp) {
+	auto it = m_footprintIndex.find(fp.name);
+	if (it != m_footprintIndex.end()) return it->second;
+
+	fp.min = fp.max = fp.pins.front();
+	for (auto &p : fp.pins) {
+		fp.min.x = std::min(fp.min.x, p.x);
+		fp.min.y = std::min(fp.min.y, p.y);
+		fp.max.x = std::max(fp.max.x, p.x);
+		fp.max.y = std::max(fp.max.y, p.y);
+	}
+	if (fp.names.empty())
+		for (size_t i = 1; i <= fp.pins.size(); i++) fp.names.push_back(std::to_string(i));
+	footprints.push_back(std::move(fp));
+	return m_footprintIndex[footprints.back().name] = footprints.size() - 1;
+}
+
+// Two rows of pins, pin 1 at the bottom left going counterclockwise
+static Footprint dual(const std::string &name, unsigned int pins, int pitch, int rowSpacing, BRDPartType type, double radius) {
+	Footprint fp{name, type, radius};
+	unsigned int perRow = (pins + 1) / 2;
+	for (unsigned int i = 0; i < pins; i++) {
+		if (i < perRow)
+			fp.pins.push_back({static_cast<int>(i) * pitch, 0});
+		else
+			fp.pins.push_back({static_cast<int>(pins - 1 - i) * pitch, rowSpacing});
+	}
+	return fp;
+}
+
+// Pins on the four sides of a square body
+static Footprint quad(const std::string &name, unsigned int pins, int pitch) {
+	Footprint fp{name, BRDPartType::SMD, 6.0};
+	int side = pins / 4;
+	int span = (side + 1) * pitch;
+	for (int i = 0; i < side; i++) fp.pins.push_back({(i + 1) * pitch, 0});
+	for (int i = 0; i < side; i++) fp.pins.push_back({span, (i + 1) * pitch});
+	for (int i = 0; i < side; i++) fp.pins.push_back({span - (i + 1) * pitch, span});
+	for (int i = 0; i < side; i++) fp.pins.push_back({0, span - (i + 1) * pitch});
+	return fp;
+}
+
+unsigned int SyntheticBoard::footprint(unsigned int pins, bool connector) {
+	if (pins == 1) return addFootprint({"TP", BRDPartType::SMD, 15.0, {{0, 0}}});
+	if (pins == 2) {
+		if (m_rng() % 2) return addFootprint({"R0402", BRDPartType::SMD, 12.0, {{0, 0}, {40, 0}}});
+		return addFootprint({"C0603", BRDPartType::SMD, 14.0, {{0, 0}, {60, 0}}});
+	}
+	if (connector) return addFootprint(dual("CONN" + std::to_string(pins), pins, 100, 100, BRDPartType::ThroughHole, 25.0));
+	if (pins >= 20 && pins % 4 == 0) return addFootprint(quad("QFP" + std::to_string(pins), pins, 20));
+	return addFootprint(dual("SOIC" + std::to_string(pins), pins, 50, 240, BRDPartType::SMD, 10.0));
+}
+
+void SyntheticBoard::place(unsigned int fp, BRDPartMountingSide side) {
+	static const char *prefixes[] = {"U", "J", "TP", "R", "C"};
+	auto &f            = footprints[fp];
+	const char *prefix = f.type == BRDPartType::ThroughHole ? prefixes[1]
+	                     : f.pins.size() == 1               ? prefixes[2]
+	                     : f.pins.size() > 2                ? prefixes[0]
+	                     : f.name[0] == 'R'                 ? prefixes[3]
+	                                                        : prefixes[4];
+	names.push_back(prefix + std::to_string(parts.size() + 1));
+
+	BRDPart part;
+	part.name          = names.back().c_str();
+	part.mfgcode       = f.name;
+	part.part_type     = f.type;
+	part.mounting_side = f.type == BRDPartType::ThroughHole ? BRDPartMountingSide::Both : side;
+	parts.push_back(part);
+	partFootprint.push_back(fp);
+	partOrigin.push_back({0, 0});
+}
+
+void SyntheticBoard::generate(const Options &options) {
+	m_rng.seed(options.seed);
+
+	// BGAs first, then ICs and passives to reach the pin count
+	unsigned int bgas    = options.bgas ? options.bgas : 1 + options.pins / 20000;
+	unsigned int bgaPins = options.bgaGrid * options.bgaGrid;
+	bgas                 = std::min(bgas, options.pins / 2 / std::max(bgaPins, 1u)); // at most half of the pins
+	if (bgas) {
+		Footprint bga{"BGA" + std::to_string(options.bgaGrid) + "X" + std::to_string(options.bgaGrid), BRDPartType::SMD, 10.0};
+		for (unsigned int row = 0; row < options.bgaGrid; row++)
+			for (unsigned int col = 0; col < options.bgaGrid; col++) {
+				bga.pins.push_back({static_cast<int>(col) * 40, static_cast<int>(row) * 40});
+				bga.names.push_back(bgaRow(row) + std::to_string(col + 1));
+			}
+		unsigned int fp = addFootprint(std::move(bga));
+		for (unsigned int i = 0; i < bgas; i++) place(fp, BRDPartMountingSide::Top);
+	}
+
+	unsigned int remaining = options.pins - bgas * bgaPins;
+	unsigned int others    = options.parts > bgas ? options.parts - bgas : std::max(1u, remaining / 3);
+	others                 = std::min(others, remaining);
+	// Passives have 2 pins, ICs 48 on average
+	unsigned int ics      = std::min(others, remaining > 2 * others ? (remaining - 2 * others + 45) / 46 : 0);
+	// With many parts for the pins, trade passives for 1 pin parts so that every IC gets a pin
+	unsigned int passives = std::min(others - ics, remaining - others);
+	ics                   = others - passives;
+
+	std::vector<unsigned int> pinCounts(passives, 2);
+	unsigned int icPins = remaining - 2 * passives;
+	if (ics) {
+		std::vector<double> weights(ics);
+		double sum = 0.0;
+		for (auto &w : weights) sum += w = 0.5 + uniform();
+		unsigned int assigned = 0;
+		for (auto w : weights) {
+			unsigned int n = std::max(1.0, std::floor(icPins * w / sum));
+			pinCounts.push_back(n);
+			assigned += n;
+		}
+		// Rounding leftovers, or the excess from the 1 pin minimum
+		for (size_t i = passives; assigned != icPins; i = i + 1 < pinCounts.size() ? i + 1 : passives) {
+			if (assigned < icPins) {
+				pinCounts[i]++;
+				assigned++;
+			} else if (pinCounts[i] > 1) {
+				pinCounts[i]--;
+				assigned--;
+			}
+		}
+	}
+	std::shuffle(pinCounts.begin(), pinCounts.end(), m_rng);
+
+	unsigned int icCount = 0;
+	for (auto n : pinCounts) {
+		bool connector = n >= 10 && n <= 120 && icCount++ % 8 == 7;
+		auto side      = uniform() < (n > 2 ? 0.8 : 0.6) ? BRDPartMountingSide::Top : BRDPartMountingSide::Bottom;
+		place(footprint(n, connector), side);
+	}
+
+	// Shelf packing, rows about as long as the board is high
+	const int gap = 40;
+	double area   = 0.0;
+	for (auto fp : partFootprint) {
+		auto &f = footprints[fp];
+		area += double(f.max.x - f.min.x + gap) * (f.max.y - f.min.y + gap);
+	}
+	int rowWidth = std::max(1000.0, std::sqrt(area * 1.3));
+	int margin   = 200;
+	int x = margin, y = margin, rowHeight = 0;
+	for (size_t i = 0; i < parts.size(); i++) {
+		auto &f = footprints[partFootprint[i]];
+		int w = f.max.x - f.min.x, h = f.max.y - f.min.y;
+		if (x > margin && x + w > margin + rowWidth) {
+			x = margin;
+			y += rowHeight + gap;
+			rowHeight = 0;
+		}
+		partOrigin[i] = {x - f.min.x, y - f.min.y};
+		x += w + gap;
+		rowHeight = std::max(rowHeight, h);
+	}
+	int width  = rowWidth + 2 * margin;
+	int height = y + rowHeight + margin;
+
+	for (size_t i = 0; i < parts.size(); i++) {
+		auto &f      = footprints[partFootprint[i]];
+		auto &origin = partOrigin[i];
+		parts[i].p1  = {origin.x + f.min.x, origin.y + f.min.y};
+		parts[i].p2  = {origin.x + f.max.x, origin.y + f.max.y};
+		for (size_t j = 0; j < f.pins.size(); j++) {
+			BRDPin pin;
+			pin.pos    = {origin.x + f.pins[j].x, origin.y + f.pins[j].y};
+			pin.part   = i + 1;
+			pin.radius = f.radius;
+			pin.snum = pin.name = f.names[j].c_str();
+			pin.side            = parts[i].mounting_side == BRDPartMountingSide::Both     ? BRDPinSide::Both
+			                      : parts[i].mounting_side == BRDPartMountingSide::Bottom ? BRDPinSide::Bottom
+			                                                                               : BRDPinSide::Top;
+			pins.push_back(pin);
+		}
+		parts[i].end_of_pins = pins.size();
+	}
+
+	connect(options);
+	generateOutline(width, height, options.arcs);
+
+	num_parts  = parts.size();
+	num_pins   = pins.size();
+	num_format = format.size();
+	valid      = true;
+}
+
+// 30% of the pins on the power nets, half of them on GND. The others in nets of 2 to 4 pins, between
+// pins that are close in the placement order so that nets stay local like on a real board.
+void SyntheticBoard::connect(const Options &options) {
+	static const char *rails[] = {"GND", "PP3V3_S0", "PP1V8_S0", "PP5V_S3", "PPVCC_CPU", "PP1V1_S0", "PPBUS_G3H", "PP0V9_S0"};
+	unsigned int powerNets     = std::max(1u, options.powerNets);
+	for (unsigned int i = 0; i < powerNets; i++) {
+		names.push_back(i < 8 ? std::string(rails[i]) : "PPVAR_" + std::to_string(i));
+		nets.push_back(names.back().c_str());
+	}
+
+	pinNet.assign(pins.size(), 0);
+	std::vector<unsigned int> signalPins;
+	for (unsigned int i = 0; i < pins.size(); i++) {
+		if (uniform() < 0.3)
+			pinNet[i] = powerNets == 1 || uniform() < 0.5 ? 0 : 1 + m_rng() % (powerNets - 1);
+		else
+			signalPins.push_back(i);
+	}
+	for (size_t i = 0; i < signalPins.size(); i += 64)
+		std::shuffle(signalPins.begin() + i, signalPins.begin() + std::min(i + 64, signalPins.size()), m_rng);
+
+	for (size_t i = 0; i < signalPins.size();) {
+		size_t n = 2 + m_rng() % 3;
+		if (signalPins.size() - i < n + 2) n = signalPins.size() - i; // no single pin net at the end
+		names.push_back("NET" + std::to_string(nets.size() - powerNets + 1));
+		nets.push_back(names.back().c_str());
+		for (size_t end = i + n; i < end; i++) pinNet[signalPins[i]] = nets.size() - 1;
+	}
+
+	for (size_t i = 0; i < pins.size(); i++) pins[i].net = nets[pinNet[i]];
+}
+
+// Rectangle with arcs bulging out of each edge. Everything is shifted by the arc radius so that
+// no coordinate is negative.
+void SyntheticBoard::generateOutline(int width, int height, unsigned int arcs) {
+	int length = std::min(width, height);
+	int r      = arcs ? std::max(1, length / static_cast<int>(4 * arcs)) : 0;
+	for (auto &part : parts) {
+		part.p1 = {part.p1.x + r, part.p1.y + r};
+		part.p2 = {part.p2.x + r, part.p2.y + r};
+	}
+	for (auto &origin : partOrigin) origin = {origin.x + r, origin.y + r};
+	for (auto &pin : pins) pin.pos = {pin.pos.x + r, pin.pos.y + r};
+	max = {width + 2 * r, height + 2 * r};
+
+	BRDPoint corners[]   = {{r, r}, {r + width, r}, {r + width, r + height}, {r, r + height}};
+	BRDPoint direction[] = {{1, 0}, {0, 1}, {-1, 0}, {0, -1}};
+	for (int edge = 0; edge < 4; edge++) {
+		BRDPoint p = corners[edge], d = direction[edge], end = corners[(edge + 1) % 4];
+		int edgeLength = abs(end.x - p.x) + abs(end.y - p.y);
+		int step       = arcs ? edgeLength / arcs : edgeLength;
+		for (unsigned int i = 0; i < arcs; i++) {
+			BRDPoint a{p.x + d.x * (step - 2 * r), p.y + d.y * (step - 2 * r)};
+			BRDPoint b{a.x + d.x * 2 * r, a.y + d.y * 2 * r};
+			BRDPoint c{a.x + d.x * r, a.y + d.y * r};
+			if (a != p) outline.push_back({false, p, a, {}});
+			outline.push_back({true, a, b, c});
+			p = b;
+		}
+		if (p != end) outline.push_back({false, p, end, {}});
+	}
+
+	auto segs = segments();
+	format.push_back(segs.front().first);
+	for (auto &s : segs) format.push_back(s.second);
+}
+
+std::vector<std::pair<BRDPoint, BRDPoint>> SyntheticBoard::segments() {
+	std::vector<std::pair<BRDPoint, BRDPoint>> segs;
+	for (auto &e : outline) {
+		if (!e.arc) {
+			segs.push_back({e.start, e.end});
+			continue;
+		}
+		double startAngle = atan2(e.start.y - e.center.y, e.start.x - e.center.x);
+		double endAngle   = atan2(e.end.y - e.center.y, e.end.x - e.center.x);
+		if (endAngle < startAngle) endAngle += 2.0 * M_PI;
+		auto arc = arc_to_segments(startAngle, endAngle, distance(e.start, e.center), e.start, e.end, e.center);
+		segs.insert(segs.end(), arc.begin(), arc.end());
+	}
+	return segs;
+}
+
+static int sideCode(BRDPinSide side) {
+	return side == BRDPinSide::Top ? 1 : side == BRDPinSide::Bottom ? 2 : 0;
+}
+
+static const char *sideLetter(BRDPinSide side) {
+	return side == BRDPinSide::Top ? "T" : side == BRDPinSide::Bottom ? "B" : "O";
+}
+
+static void writeBRD(FILE *f, SyntheticBoard &board) {
+	fprintf(f, "str_length:\nvar_data:\n%zu %zu %zu 0\n", board.format.size(), board.parts.size(), board.pins.size());
+	fprintf(f, "Format:\n");
+	for (auto &p : board.format) fprintf(f, "%d %d\n", p.x, p.y);
+	fprintf(f, "Parts:\n");
+	for (auto &part : board.parts) {
+		// Type and layer: 1 through hole, 5 SMD on top, 10 SMD on bottom
+		int type = part.part_type == BRDPartType::ThroughHole ? 1 : part.mounting_side == BRDPartMountingSide::Bottom ? 10 : 5;
+		fprintf(f, "%s %d %u\n", part.name, type, part.end_of_pins);
+	}
+	fprintf(f, "Pins:\n");
+	for (auto &pin : board.pins) fprintf(f, "%d %d 0 %u %s\n", pin.pos.x, pin.pos.y, pin.part, pin.net);
+	fprintf(f, "Nails:\n");
+}
+
+// Bottom side coordinates are mirrored along Y in this format
+static void writeBRD2(FILE *f, SyntheticBoard &board) {
+	fprintf(f, "BRDOUT: %zu %d %d\n", board.format.size(), board.max.x, board.max.y);
+	for (auto &p : board.format) fprintf(f, "%d %d\n", p.x, p.y);
+	fprintf(f, "\nNETS: %zu\n", board.nets.size());
+	for (size_t i = 0; i < board.nets.size(); i++) fprintf(f, "%zu %s\n", i + 1, board.nets[i]);
+	fprintf(f, "\nPARTS: %zu\n", board.parts.size());
+	unsigned int firstPin = 0;
+	for (auto &part : board.parts) {
+		int side = part.mounting_side == BRDPartMountingSide::Top ? 1 : part.mounting_side == BRDPartMountingSide::Bottom ? 2 : 0;
+		int y1 = part.p1.y, y2 = part.p2.y;
+		if (side == 2) {
+			y1 = board.max.y - y1;
+			y2 = board.max.y - y2;
+		}
+		fprintf(f, "%s %d %d %d %d %u %d\n", part.name, part.p1.x, y1, part.p2.x, y2, firstPin, side);
+		firstPin = part.end_of_pins;
+	}
+	fprintf(f, "\nPINS: %zu\n", board.pins.size());
+	for (size_t i = 0; i < board.pins.size(); i++) {
+		auto &pin = board.pins[i];
+		int y     = pin.side == BRDPinSide::Top ? pin.pos.y : board.max.y - pin.pos.y;
+		fprintf(f, "%d %d %u %d\n", pin.pos.x, y, board.pinNet[i] + 1, sideCode(pin.side));
+	}
+	fprintf(f, "\nNAILS: 0\n");
+}
+
+static void writeBVR3(FILE *f, SyntheticBoard &board) {
+	fprintf(f, "BVRAW_FORMAT_3\n");
+	size_t pin = 0;
+	for (size_t i = 0; i < board.parts.size(); i++) {
+		auto &part   = board.parts[i];
+		auto &origin = board.partOrigin[i];
+		const char *side = part.mounting_side == BRDPartMountingSide::Top ? "T" : part.mounting_side == BRDPartMountingSide::Bottom ? "B" : "O";
+		fprintf(f, "PART_NAME %s\n", part.name);
+		fprintf(f, "   PART_SIDE %s\n", side);
+		fprintf(f, "   PART_ORIGIN %d.000 %d.000\n", origin.x, origin.y);
+		fprintf(f, "   PART_MOUNT %s\n", part.part_type == BRDPartType::SMD ? "SMD" : "TH");
+		for (unsigned int id = 1; pin < part.end_of_pins; pin++, id++) {
+			auto &p = board.pins[pin];
+			fprintf(f, "   PIN_ID %u\n", id);
+			fprintf(f, "      PIN_NUMBER %s\n", p.snum);
+			fprintf(f, "      PIN_NAME %s\n", p.name);
+			fprintf(f, "      PIN_SIDE %s\n", sideLetter(p.side));
+			fprintf(f, "      PIN_ORIGIN %d.000 %d.000\n", p.pos.x, p.pos.y);
+			fprintf(f, "      PIN_RADIUS %.3f\n", p.radius);
+			fprintf(f, "      PIN_NET %s\n", p.net);
+			fprintf(f, "   PIN_END\n");
+		}
+		fprintf(f, "PART_END\n\n");
+	}
+	fprintf(f, "OUTLINE_SEGMENTED");
+	for (auto &s : board.segments()) fprintf(f, " %d %d %d %d", s.first.x, s.first.y, s.second.x, s.second.y);
+	fprintf(f, "\n");
+}
+
+// One shape per footprint, flipped for the parts on the bottom
+static void writeGenCAD(FILE *f, SyntheticBoard &board) {
+	fprintf(f, "$HEADER\nGENCAD 1.4\nUSER \"OpenBoardView synthetic board\"\nDRAWING synthetic\nREVISION 1\nUNITS THOU\nORIGIN 0 0\n$ENDHEADER\n");
+
+	fprintf(f, "$BOARD\nTHICKNESS 62\n");
+	for (auto &e : board.outline) {
+		if (e.arc)
+			fprintf(f, "ARC %d %d %d %d %d %d\n", e.start.x, e.start.y, e.end.x, e.end.y, e.center.x, e.center.y);
+		else
+			fprintf(f, "LINE %d %d %d %d\n", e.start.x, e.start.y, e.end.x, e.end.y);
+	}
+	fprintf(f, "$ENDBOARD\n");
+
+	fprintf(f, "$PADS\nPAD P_ROUND ROUND 0\nCIRCLE 0 0 10\n$ENDPADS\n");
+	fprintf(f, "$PADSTACKS\nPADSTACK PS_SMD 0\nPAD P_ROUND TOP 0 0\n");
+	fprintf(f, "PADSTACK PS_TH 30\nPAD P_ROUND TOP 0 0\nPAD P_ROUND BOTTOM 0 0\n$ENDPADSTACKS\n");
+
+	fprintf(f, "$SHAPES\n");
+	for (auto &fp : board.footprints) {
+		const char *padstack = fp.type == BRDPartType::SMD ? "PS_SMD" : "PS_TH";
+		fprintf(f, "SHAPE %s\n", fp.name.c_str());
+		for (size_t i = 0; i < fp.pins.size(); i++)
+			fprintf(f, "PIN %s %s %d %d TOP 0 0\n", fp.names[i].c_str(), padstack, fp.pins[i].x, fp.pins[i].y);
+	}
+	fprintf(f, "$ENDSHAPES\n");
+
+	fprintf(f, "$COMPONENTS\n");
+	for (size_t i = 0; i < board.parts.size(); i++) {
+		auto &part   = board.parts[i];
+		auto &origin = board.partOrigin[i];
+		bool bottom  = part.mounting_side == BRDPartMountingSide::Bottom;
+		fprintf(f, "COMPONENT %s\n", part.name);
+		fprintf(f, "DEVICE DEV_%s\n", part.mfgcode.c_str());
+		fprintf(f, "PLACE %d %d\n", origin.x, origin.y);
+		fprintf(f, "LAYER %s\n", bottom ? "BOTTOM" : "TOP");
+		fprintf(f, "ROTATION 0\n");
+		fprintf(f, "SHAPE %s 0 %s\n", part.mfgcode.c_str(), bottom ? "FLIP" : "0");
+	}
+	fprintf(f, "$ENDCOMPONENTS\n");
+
+	fprintf(f, "$DEVICES\n");
+	for (auto &fp : board.footprints) fprintf(f, "DEVICE DEV_%s\nPART %s\n", fp.name.c_str(), fp.name.c_str());
+	fprintf(f, "$ENDDEVICES\n");
+
+	std::vector<std::vector<unsigned int>> netPins(board.nets.size());
+	for (unsigned int i = 0; i < board.pins.size(); i++) netPins[board.pinNet[i]].push_back(i);
+	fprintf(f, "$SIGNALS\n");
+	for (size_t n = 0; n < board.nets.size(); n++) {
+		fprintf(f, "SIGNAL %s\n", board.nets[n]);
+		for (auto i : netPins[n]) fprintf(f, "NODE %s %s\n", board.parts[board.pins[i].part - 1].name, board.pins[i].snum);
+	}
+	fprintf(f, "$ENDSIGNALS\n");
+}
+
+// ASC boards are a directory, coordinates in inches. The parser skips a few lines after the first one of each
+// file, they must not be empty: stringfile() merges consecutive line breaks.
+static void writeAscHeader(FILE *f, const char *title, int skipped) {
+	fprintf(f, "%s\n", title);
+	for (int i = 0; i < skipped; i++) fprintf(f, "# OpenBoardView synthetic board\n");
+}
+
+static bool writeASC(const filesystem::path &dir, SyntheticBoard &board) {
+	std::error_code ec;
+	filesystem::create_directories(dir, ec);
+	FILE *format = fopen((dir / "format.asc").string().c_str(), "wb");
+	FILE *pins   = fopen((dir / "pins.asc").string().c_str(), "wb");
+	FILE *nails  = fopen((dir / "nails.asc").string().c_str(), "wb");
+	if (format && pins && nails) {
+		writeAscHeader(format, "<<format.asc>>", 7);
+		for (auto &p : board.format) fprintf(format, "%.3f %.3f\n", p.x / 1000.0, p.y / 1000.0);
+
+		writeAscHeader(pins, "<<pins.asc>>", 7);
+		size_t pin = 0;
+		for (auto &part : board.parts) {
+			fprintf(pins, "Part %s %s\n", part.name, part.mounting_side == BRDPartMountingSide::Bottom ? "(B)" : "(T)");
+			for (unsigned int id = 1; pin < part.end_of_pins; pin++, id++) {
+				auto &p = board.pins[pin];
+				fprintf(pins, "%u %s  %.3f %.3f %d %s 0\n", id, p.snum, p.pos.x / 1000.0, p.pos.y / 1000.0, sideCode(p.side), p.net);
+			}
+		}
+
+		writeAscHeader(nails, "<<nails.asc>>", 6);
+	}
+	bool ok = format && pins && nails;
+	for (FILE *f : {format, pins, nails})
+		if (f) fclose(f);
+	return ok;
+}
+
+// Read the file back through format detection and the parser, compare the pin count
+static bool check(const filesystem::path &path, const SyntheticBoard &board) {
+	std::string error;
+	std::vector<char> buffer = file_as_buffer(path, error);
+	BoardFormat format       = detectBoardFormat(path, buffer, BoardFileKeys());
+	if (!format.open) {
+		fprintf(stderr, "  check: %s not recognized %s\n", path.string().c_str(), error.c_str());
+		return false;
+	}
+	BRDFileBase *file = format.open(buffer);
+	bool ok           = file->valid && file->pins.size() == board.pins.size();
+	fprintf(stderr,
+	        "  check: %s read as %s, %zu parts, %zu pins%s%s\n",
+	        path.string().c_str(),
+	        format.name,
+	        file->parts.size(),
+	        file->pins.size(),
+	        ok ? "" : " MISMATCH ",
+	        file->error_msg.c_str());
+	delete file;
+	return ok;
+}
+
+static void usage(const char *name) {
+	fprintf(stderr,
+	        "Usage: %s [-n pins] [-c parts] [-b bgas] [-g grid] [-p power nets] [-a arcs] [-s seed]\n"
+	        "       [-f brd,brd2,bvr3,gencad,asc] [--check] <output directory>\n",
+	        name);
+}
+
+int main(int argc, char **argv) {
+	Options options;
+	filesystem::path dir;
+	for (int i = 1; i < argc; i++) {
+		const char *arg = argv[i];
+		if (!strcmp(arg, "--check")) {
+			options.check = true;
+		} else if (arg[0] == '-' && arg[1] && !arg[2] && i + 1 < argc) {
+			const char *value = argv[++i];
+			switch (arg[1]) {
+				case 'n': options.pins = strtoul(value, nullptr, 10); break;
+				case 'c': options.parts = strtoul(value, nullptr, 10); break;
+				case 'b': options.bgas = strtoul(value, nullptr, 10); break;
+				case 'g': options.bgaGrid = strtoul(value, nullptr, 10); break;
+				case 'p': options.powerNets = strtoul(value, nullptr, 10); break;
+				case 'a': options.arcs = strtoul(value, nullptr, 10); break;
+				case 's': options.seed = strtoul(value, nullptr, 10); break;
+				case 'f': options.formats = value; break;
+				default: usage(argv[0]); return 1;
+			}
+		} else if (dir.empty() && arg[0] != '-') {
+			dir = arg;
+		} else {
+			usage(argv[0]);
+			return 1;
+		}
+	}
+	if (dir.empty() || options.pins < 2 || options.bgaGrid == 0) {
+		usage(argv[0]);
+		return 1;
+	}
+	std::error_code ec;
+	filesystem::create_directories(dir, ec);
+	if (ec) {
+		fprintf(stderr, "Cannot create %s: %s\n", dir.string().c_str(), ec.message().c_str());
+		return 1;
+	}
+
+	SyntheticBoard board;
+	board.generate(options);
+	unsigned int arcs = std::count_if(board.outline.begin(), board.outline.end(), [](const OutlineEdge &e) { return e.arc; });
+	printf("%zu parts, %zu pins, %zu nets, %zu footprints, outline of %zu edges (%u arcs)\n",
+	       board.parts.size(),
+	       board.pins.size(),
+	       board.nets.size(),
+	       board.footprints.size(),
+	       board.outline.size(),
+	       arcs);
+
+	static const struct {
+		const char *format, *suffix;
+		void (*write)(FILE *, SyntheticBoard &);
+	} writers[] = {
+	    {"brd", ".brd", writeBRD},
+	    {"brd2", "-brd2.brd", writeBRD2},
+	    {"bvr3", ".bvr", writeBVR3},
+	    {"gencad", ".cad", writeGenCAD},
+	};
+	std::string base = "synthetic-" + std::to_string(options.pins);
+	std::string formats = "," + options.formats + ",";
+	bool ok             = true;
+
+	for (auto &w : writers) {
+		if (formats.find("," + std::string(w.format) + ",") == std::string::npos) continue;
+		filesystem::path path = dir / (base + w.suffix);
+		FILE *f               = fopen(path.string().c_str(), "wb");
+		if (!f) {
+			fprintf(stderr, "Cannot write %s\n", path.string().c_str());
+			ok = false;
+			continue;
+		}
+		w.write(f, board);
+		fclose(f);
+		printf("Wrote %s\n", path.string().c_str());
+		if (options.check) ok &= check(path, board);
+	}
+
+	if (formats.find(",asc,") != std::string::npos) {
+		filesystem::path path = dir / (base + "-asc");
+		if (writeASC(path, board)) {
+			printf("Wrote %s\n", (path / "pins.asc").string().c_str());
+			if (options.check) ok &= check(path / "pins.asc", board);
+		} else {
+			fprintf(stderr, "Cannot write %s\n", path.string().c_str());
+			ok = false;
+		}
+	}
+	return ok ? 0 : 1;
+}
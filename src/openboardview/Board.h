@@ -102,6 +102,9 @@ struct Net : BoardElement {
 
 	SharedVector<Pin> pins;
 
+	// LabelCache id of name
+	uint32_t name_label = 0;
+
 	std::string UniqueId() const {
 		return kBoardNetPrefix + name;
 	}
@@ -140,6 +143,9 @@ struct Pin : BoardElement {
 	// Contact belonging to this component (pin), nullptr if nail.
 	std::shared_ptr<Component> component;
 
+	// LabelCache id of name
+	uint32_t name_label = 0;
+
 	std::string UniqueId() const {
 		return kBoardPinPrefix + number;
 	}
@@ -188,6 +194,10 @@ struct Component : BoardElement {
 	ImVec2 centerpoint;
 	double expanse = 0.0f; // quick measure of distance between pins.
 
+	// LabelCache ids of name and mfgcode
+	uint32_t name_label    = 0;
+	uint32_t mfgcode_label = 0;
+
 	// enum ComponentVisualModes { CVMNormal = 0, CVMSelected, CVMShowPins, CVMModeCount };
 	enum ComponentVisualModes { CVMNormal = 0, CVMSelected, CVMModeCount };
 
@@ -226,6 +236,16 @@ class Board {
 	virtual SharedVector<Point> &OutlinePoints()                    = 0;
 	virtual std::vector<std::pair<Point, Point>> &OutlineSegments() = 0;
 
+	// Exact name lookups, index in Nets()/Components() or -1 when not found.
+	// Components are sorted by name, parts sharing the name follow the returned one.
+	virtual int NetIndex(const std::string &name)       = 0;
+	virtual int ComponentIndex(const std::string &name) = 0;
+
+	// Indices in Pins()/Components() of the elements seen from side (kBoardSideTop or kBoardSideBottom),
+	// those on that side and on both sides, in the same order.
+	virtual const std::vector<uint32_t> &PinsOnSide(int side)       = 0;
+	virtual const std::vector<uint32_t> &ComponentsOnSide(int side) = 0;
+
 	EBoardType BoardType() {
 		return kBoardTypeUnknown;
 	}
@@ -0,0 +1,90 @@
+#include "BoardStats.h"
+#include "Trace.h"
+
+#include <algorithm>
+
+template <class T> static std::vector<ElementStats> elementStats(const SharedVector<T> &elements) {
+	std::vector<ElementStats> stats(elements.size());
+	for (size_t i = 0; i < elements.size(); i++) {
+		auto &s = stats[i];
+		for (auto &pin : elements[i]->pins) {
+			auto &p = pin->position;
+			if (!s.pins) {
+				s.min = s.max = p;
+			} else {
+				s.min.x = std::min(s.min.x, p.x);
+				s.min.y = std::min(s.min.y, p.y);
+				s.max.x = std::max(s.max.x, p.x);
+				s.max.y = std::max(s.max.y, p.y);
+			}
+			s.pins++;
+			if (pin->board_side != kBoardSideBottom) s.pinsTop++;
+			if (pin->board_side != kBoardSideTop) s.pinsBottom++;
+			if (pin->type == Pin::kPinTypeTestPad) s.testPads++;
+			if (pin->type == Pin::kPinTypeNotConnected) s.notConnected++;
+			if (pin->net && pin->net->is_ground) s.ground = true;
+		}
+	}
+	return stats;
+}
+
+void BoardStats::wait() {
+	std::unique_lock<std::mutex> lock(m_mutex);
+	m_done.wait(lock, [this] { return !m_pending; });
+}
+
+void BoardStats::compute(Board *board) {
+	clear();
+	{
+		std::lock_guard<std::mutex> lock(m_mutex);
+		m_pending = true;
+	}
+	m_pool.submit([this, board] {
+		TraceScope trace("BoardStats");
+		auto nets  = elementStats(board->Nets());
+		auto parts = elementStats(board->Components());
+		std::unordered_map<const Component *, uint32_t> partIndex;
+		partIndex.reserve(board->Components().size());
+		for (uint32_t i = 0; i < board->Components().size(); i++) partIndex.emplace(board->Components()[i].get(), i);
+
+		std::lock_guard<std::mutex> lock(m_mutex);
+		m_nets.swap(nets);
+		m_parts.swap(parts);
+		m_partIndex.swap(partIndex);
+		m_pending = false;
+		m_done.notify_all();
+	});
+}
+
+void BoardStats::clear() {
+	wait();
+	m_nets.clear();
+	m_parts.clear();
+	m_partIndex.clear();
+}
+
+const ElementStats &BoardStats::net(size_t index) {
+	wait();
+	return m_nets.at(index);
+}
+
+const ElementStats &BoardStats::part(size_t index) {
+	wait();
+	return m_parts.at(index);
+}
+
+const std::vector<ElementStats> &BoardStats::nets() {
+	wait();
+	return m_nets;
+}
+
+const std::vector<ElementStats> &BoardStats::parts() {
+	wait();
+	return m_parts;
+}
+
+const ElementStats *BoardStats::part(const Component *part) {
+	wait();
+	auto it = m_partIndex.find(part);
+	return it == m_partIndex.end() ? nullptr : &m_parts[it->second];
+}
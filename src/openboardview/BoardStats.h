@@ -0,0 +1,64 @@
+#ifndef _BOARDSTATS_H_
+#define _BOARDSTATS_H_
+
+#include "Board.h"
+#include "WorkerPool.h"
+
+#include <condition_variable>
+#include <cstdint>
+#include <mutex>
+#include <unordered_map>
+#include <vector>
+
+// Pin statistics of a net or part
+struct ElementStats {
+	uint32_t pins         = 0;
+	uint32_t pinsTop      = 0; // top and both sides pins
+	uint32_t pinsBottom   = 0; // bottom and both sides pins
+	uint32_t testPads     = 0;
+	uint32_t notConnected = 0;
+	bool ground           = false;
+	Point min, max; // bounding box of the pin positions, only valid when pins > 0
+
+	// Side all pins are on, kBoardSideBoth when mixed or without pins
+	EBoardSide side() const {
+		if (pins && !pinsBottom) return kBoardSideTop;
+		if (pins && !pinsTop) return kBoardSideBottom;
+		return kBoardSideBoth;
+	}
+	bool nc() const {
+		return pins && notConnected == pins;
+	}
+};
+
+// Per net and per part statistics, computed once per board on a worker thread.
+// Lookups wait for the computation to finish, board loading carries on in the meantime.
+class BoardStats {
+	std::mutex m_mutex;
+	std::condition_variable m_done;
+	bool m_pending = false;
+
+	std::vector<ElementStats> m_nets, m_parts;
+	std::unordered_map<const Component *, uint32_t> m_partIndex;
+
+	WorkerPool m_pool{1};
+
+	void wait();
+
+public:
+	// Start computing the statistics of board, after the previous computation if any
+	void compute(Board *board);
+	// Wait for the computation and drop the statistics, board can be deleted afterwards
+	void clear();
+
+	// Statistics of Nets()[index] and Components()[index]
+	const ElementStats &net(size_t index);
+	const ElementStats &part(size_t index);
+	// All of them at once, indexed like Nets() and Components(), for loops that would otherwise wait on every lookup
+	const std::vector<ElementStats> &nets();
+	const std::vector<ElementStats> &parts();
+	// nullptr when part is not on the board
+	const ElementStats *part(const Component *part);
+};
+
+#endif
@@ -4,6 +4,7 @@
 #include "utf8/utf8.h"
 #include "utils.h"
 
+#include <algorithm>
 #include <cmath>
 #include <iostream>
 #include <climits>
@@ -15,20 +16,7 @@
 
 #include "BRDBoard.h"
 #include "Board.h"
-#include "FileFormats/ADFile.h"
-#include "FileFormats/ASCFile.h"
-#include "FileFormats/BDVFile.h"
-#include "FileFormats/BRD2File.h"
-#include "FileFormats/BRDAllegroFile.h"
-#include "FileFormats/BRDFile.h"
-#include "FileFormats/BVRFile.h"
-#include "FileFormats/BVR3File.h"
-#include "FileFormats/CADFile.h"
-#include "FileFormats/CAEFile.h"
-#include "FileFormats/CSTFile.h"
-#include "FileFormats/FZFile.h"
-#include "FileFormats/GenCADFile.h"
-#include "FileFormats/XZZPCBFile.h"
+#include "FileFormats/BoardFormat.h"
 #include "GUI/DPI.h"
 #include "GUI/Fonts.h"
 #include "GUI/widgets.h"
@@ -39,6 +27,7 @@
 
 #include "NetList.h"
 #include "PartList.h"
+#include "Renderers/Renderers.h"
 #include "vectorhulls.h"
 
 #if _MSC_VER
@@ -51,6 +40,7 @@
 
 BoardView::~BoardView() {
 	if (m_validBoard) {
+		m_boardStats.clear();
 		m_board->Nets().clear();
 		m_board->Pins().clear();
 		m_board->Components().clear();
@@ -61,6 +51,7 @@ BoardView::~BoardView() {
 		m_annotations.Close();
 		m_validBoard = false;
 	}
+	for (auto layer : m_drawLayers) IM_DELETE(layer);
 }
 
 int BoardView::ConfigParse(void) {
@@ -83,6 +74,8 @@ int BoardView::ConfigParse(void) {
 }
 
 int BoardView::LoadFile(const filesystem::path &filepath) {
+	Trace::restartFrames();
+	TraceScope trace("LoadFile", filepath.string());
 	m_lastFileOpenWasInvalid = true;
 	m_validBoard             = false;
 	if (!filepath.empty()) {
@@ -91,6 +84,7 @@ int BoardView::LoadFile(const filesystem::path &filepath) {
 			m_pinHighlighted.clear();
 			m_partHighlighted.clear();
 			m_annotations.Close();
+			m_boardStats.clear();
 			m_board->Nets().clear();
 			m_board->Pins().clear();
 			m_board->Components().clear();
@@ -106,42 +100,29 @@ int BoardView::LoadFile(const filesystem::path &filepath) {
 		pdfBridge.CloseDocument();
 
 		SetLastFileOpenName(filepath.string());
-		std::vector<char> buffer = file_as_buffer(filepath, m_error_msg);
+		std::vector<char> buffer;
+		{
+			TraceScope trace("Read");
+			buffer = file_as_buffer(filepath, m_error_msg);
+		}
 		if (!buffer.empty()) {
-			if (check_fileext(filepath, ".fz")) { // Since it is encrypted we cannot use the below logic. Trust the ext.
-				FZFile *fzfile = new FZFile();
-				fzfile->parse(buffer, config.FZKey);
-				m_file = fzfile;
-			} else if (check_fileext(filepath, ".cae")) { // Since it is encrypted we cannot use the below logic. Trust the ext.
-				CAEFile *caefile = new CAEFile();
-				caefile->parse(buffer, config.CAEKey);
-				m_file = caefile;
-			} else if (check_fileext(filepath, ".bom") || check_fileext(filepath, ".asc"))
-				m_file = new ASCFile(buffer, filepath);
-			else if (GenCADFile::verifyFormat(buffer))
-				m_file = new GenCADFile(buffer);
-			else if (ADFile::verifyFormat(buffer))
-				m_file = new ADFile(buffer);
-			else if (CADFile::verifyFormat(buffer))
-				m_file = new CADFile(buffer);
-			else if (check_fileext(filepath, ".cst"))
-				m_file = new CSTFile(buffer);
-			else if (BRDFile::verifyFormat(buffer))
-				m_file = new BRDFile(buffer);
-			else if (BRD2File::verifyFormat(buffer))
-				m_file = new BRD2File(buffer);
-			else if (BDVFile::verifyFormat(buffer))
-				m_file = new BDVFile(buffer);
-			else if (BVRFile::verifyFormat(buffer))
-				m_file = new BVRFile(buffer);
-			else if (BVR3File::verifyFormat(buffer))
-				m_file = new BVR3File(buffer);
-			else if (BRDAllegroFile::verifyFormat(buffer))
-				m_file = new BRDAllegroFile(buffer);
-			else if (XZZPCBFile::verifyFormat(buffer))
-				m_file = new XZZPCBFile(buffer, config.XZZPCBKey);
-			else
+			BoardFileKeys keys;
+			keys.fz  = config.FZKey;
+			keys.cae = config.CAEKey;
+			keys.xzz = config.XZZPCBKey;
+
+			BoardFormat format;
+			{
+				TraceScope trace("Detect format");
+				format = detectBoardFormat(filepath, buffer, keys);
+			}
+
+			if (format.open) {
+				TraceScope trace("Parse", format.name);
+				m_file = format.open(buffer);
+			} else {
 				m_error_msg = "Unrecognized file format.";
+			}
 
 			if (m_file && m_file->valid) {
 				LoadBoard(m_file);
@@ -150,7 +131,10 @@ int BoardView::LoadFile(const filesystem::path &filepath) {
 				boardMinMaxDone          = false;
 				m_rotation               = 0;
 				m_current_side           = 0;
-				EPCCheck(); // check to see we don't have a flipped board outline
+				{
+					TraceScope trace("EPCCheck");
+					EPCCheck(); // check to see we don't have a flipped board outline
+				}
 
 				m_annotations.SetFilename(filepath.string());
 				m_annotations.Load();
@@ -160,7 +144,10 @@ int BoardView::LoadFile(const filesystem::path &filepath) {
 				backgroundImage.loadFromConfig(conffilepath);
 				pdfFile.loadFromConfig(conffilepath);
 
-				pdfBridge.OpenDocument(pdfFile);
+				{
+					TraceScope trace("PDF open");
+					pdfBridge.OpenDocument(pdfFile);
+				}
 
 				/*
 				 * Set pins to a known lower size, they get resized
@@ -391,7 +378,7 @@ void BoardView::ShowInfoPane(void) {
 							m_partHighlighted.push_back(pin->component);
 							CenterZoomNet(pin->net->name);
 						}
-						m_needsRedraw = true;
+						m_needsRedrawSelection = true;
 					}
 					ImGui::PushStyleColor(ImGuiCol_Border, 0xffeeeeee);
 					ImGui::Separator();
@@ -492,11 +479,10 @@ void BoardView::ContextMenu(void) {
 				 * but haven't decided what to do in such a situation
 				 */
 
-				for (auto &part : m_board->Components()) {
-					int hit = 0;
-					//					auto p_part = part.get();
-
-					if (!BoardElementIsVisible(part)) continue;
+				auto &parts = m_board->Components();
+				for (auto index : m_board->ComponentsOnSide(m_current_side)) {
+					auto &part = parts[index];
+					int hit    = 0;
 
 					// Work out if the point is inside the hull
 					{
@@ -551,8 +537,7 @@ void BoardView::ContextMenu(void) {
 						if (ImGui::Button("Update##1") || keybindings.isPressed("Validate")) {
 							m_annotationedit_retain = false;
 							m_annotations.Update(m_annotations.annotations[m_annotation_clicked_id].id, contextbuf);
-							m_annotations.GenerateList();
-							m_needsRedraw      = true;
+							m_needsRedrawAnnotations = true;
 							ImGui::CloseCurrentPopup();
 						}
 						ImGui::SameLine();
@@ -609,8 +594,7 @@ void BoardView::ContextMenu(void) {
 						if (debug) fprintf(stderr, "DATA:'%s'\n\n", contextbufnew);
 
 						m_annotations.Add(m_current_side, tx, ty, net.c_str(), partn.c_str(), pin.c_str(), contextbufnew);
-						m_annotations.GenerateList();
-						m_needsRedraw = true;
+						m_needsRedrawAnnotations = true;
 
 						ImGui::CloseCurrentPopup();
 					}
@@ -627,8 +611,7 @@ void BoardView::ContextMenu(void) {
 
 				if ((m_annotation_clicked_id >= 0) && (ImGui::Button("Remove"))) {
 					m_annotations.Remove(m_annotations.annotations[m_annotation_clicked_id].id);
-					m_annotations.GenerateList();
-					m_needsRedraw = true;
+					m_needsRedrawAnnotations = true;
 					ImGui::CloseCurrentPopup();
 				}
 			}
@@ -653,12 +636,22 @@ void BoardView::ContextMenu(void) {
 	}
 }
 
-std::pair<SharedVector<Component>, SharedVector<Net>> BoardView::SearchPartsAndNets(const char *search, int limit) {
-	SharedVector<Component> parts;
-	SharedVector<Net> nets;
-	if (m_searchComponents) parts = searcher.parts(search, limit);
-	if (m_searchNets) nets = searcher.nets(search, limit);
-	return {parts, nets};
+// Same as SearchCompound() with results of an asynchronous search
+void BoardView::HighlightSearchResults(const std::pair<SharedVector<Component>, SharedVector<Net>> &results) {
+	m_pinHighlighted.clear();
+	m_partHighlighted.clear();
+	m_needsRedrawSelection = true;
+
+	for (auto &p : results.first) {
+		m_partHighlighted.push_back(p);
+		for (auto &pin : p->pins) m_pinHighlighted.push_back(pin);
+	}
+	for (auto &net : results.second) {
+		for (auto &pin : net->pins) m_pinHighlighted.push_back(pin);
+	}
+
+	if (!m_partHighlighted.empty() && !m_pinHighlighted.empty() && !AnyItemVisible())
+		FlipBoard(1); // passing 1 to override flipBoard parameter
 }
 
 const char *getcname(const std::string &name) {
@@ -671,7 +664,7 @@ const char *getcname(const T &t) {
 }
 
 template <class T>
-void BoardView::ShowSearchResults(std::vector<T> results, char *search, int &limit, void (BoardView::*onSelect)(const char *)) {
+void BoardView::ShowSearchResults(const std::vector<T> &results, char *search, int &limit, void (BoardView::*onSelect)(const char *)) {
 	for (auto &r : results) {
 		const char *cname = getcname(r);
 		if (ImGui::Selectable(cname, false)) {
@@ -688,10 +681,11 @@ void BoardView::SearchColumnGenerate(const std::string &title,
                                      char *search,
                                      int limit) {
 	if (ImGui::BeginListBox(title.c_str())) {
+		size_t max_suggestions = std::max(limit, 1);
 
 		if (m_searchComponents) {
 			if (results.first.empty() && (!m_searchNets || results.second.empty())) { // show suggestions only if there is no result at all
-				auto s = scparts.suggest(search);
+				const auto &s = scparts.suggest(search, max_suggestions);
 				if (s.size() > 0) {
 					ImGui::Text("Did you mean...");
 					ShowSearchResults(s, search, limit, &BoardView::FindComponent);
@@ -702,7 +696,7 @@ void BoardView::SearchColumnGenerate(const std::string &title,
 
 		if (m_searchNets) {
 			if (results.second.empty() && (!m_searchComponents || results.first.empty())) {
-				auto s = scnets.suggest(search);
+				const auto &s = scnets.suggest(search, max_suggestions);
 				if (s.size() > 0) {
 					ImGui::Text("Did you mean...");
 					ShowSearchResults(s, search, limit, &BoardView::FindNet);
@@ -716,6 +710,7 @@ void BoardView::SearchColumnGenerate(const std::string &title,
 }
 
 void BoardView::SearchComponent(void) {
+	ProfileScope profile(profiler, Profiler::kSearch);
 	bool dummy = true;
 	ImGui::SetNextWindowPos(ImVec2(ImGui::GetIO().DisplaySize.x/2, DPI(100)), 0, ImVec2(0.5f, 0.0f));
 	ImGui::PushStyleVar(ImGuiStyleVar_WindowBorderSize, 1.0f);
@@ -804,9 +799,16 @@ void BoardView::SearchComponent(void) {
 
 			ImGui::PushItemWidth(-1);
 
-			bool textNonEmpty = m_search[i][0] != '\0';                            // Text typed in the search box
-			auto results      = SearchPartsAndNets(m_search[i], 30);               // Perform the search for both nets and parts
-			bool hasResults   = !results.first.empty() || !results.second.empty(); // We found some nets or some parts
+			bool textNonEmpty = m_search[i][0] != '\0'; // Text typed in the search box
+
+			// Search both nets and parts in the background, restarted when the text or search options changed
+			auto &query = m_searchQueries[i];
+			if (!query || !searcher.isCurrent(*query, m_search[i], m_searchComponents, m_searchNets)) {
+				if (query) query->cancel();
+				query = searcher.searchAsync(m_search[i], m_searchComponents, m_searchNets);
+			}
+			auto results    = searcher.results(*query, 30); // Whatever was found so far
+			bool hasResults = !results.first.empty() || !results.second.empty() || !query->done(); // We found some nets or some parts
 
 			if (textNonEmpty && !hasResults) ImGui::PushStyleColor(ImGuiCol_FrameBg, 0xFF6666FF);
 			bool textChanged =
@@ -823,7 +825,14 @@ void BoardView::SearchComponent(void) {
 
 			bool this_column_active = i == m_active_search_column;
 
-			if (textChanged || (search_params_changed && this_column_active)) SearchCompound(m_search[i]);
+			if (textChanged || (search_params_changed && this_column_active)) m_searchHighlightPending[i] = true;
+
+			// Highlight on the board once the search for the current text is complete
+			if (m_searchHighlightPending[i] && searcher.isCurrent(*query, m_search[i], m_searchComponents, m_searchNets) &&
+			    query->done()) {
+				m_searchHighlightPending[i] = false;
+				HighlightSearchResults(searcher.results(*query, -1));
+			}
 
 			ImGui::PopItemWidth();
 
@@ -876,7 +885,7 @@ void BoardView::ClearAllHighlights(void) {
 	FindNet("");
 	FindComponent("");
 	ResetSearch();
-	m_needsRedraw      = true;
+	m_needsRedrawSelection = true;
 	if (m_board != NULL) {
 		for (auto part : m_board->Components()) part->visualmode = part->CVMNormal;
 	}
@@ -891,6 +900,7 @@ void BoardView::ClearAllHighlights(void) {
  *
  */
 void BoardView::Update() {
+	ProfileScope profile(profiler, Profiler::kUpdate);
 	bool open_file = false;
 	char *preset_filename = NULL;
 	ImGuiIO &io           = ImGui::GetIO();
@@ -991,6 +1001,7 @@ void BoardView::Update() {
 			if (MenuItemWithCheckbox("Show FPS", {}, config.showFPS)) {
 				obvconfig.WriteBool("showFPS", config.showFPS);
 			}
+			MenuItemWithCheckbox("Show profiler", {}, m_showProfiler);
 
 			if (MenuItemWithCheckbox("Show position", {}, config.showPosition)) {
 				obvconfig.WriteBool("showPosition", config.showPosition);
@@ -1376,6 +1387,7 @@ void BoardView::Pan(int direction, int amount) {
  * for menus is handled within the menu generation itself.
  */
 void BoardView::HandleInput() {
+	ProfileScope profile(profiler, Profiler::kHandleInput);
 	if (!m_board || (!m_file)) return;
 
 	const ImGuiIO &io = ImGui::GetIO();
@@ -1422,7 +1434,6 @@ void BoardView::HandleInput() {
 						m_annotationedit_retain = false;
 						m_showContextMenu       = true;
 						m_showContextMenuPos    = spos;
-						m_needsRedraw           = true;
 						if (debug) fprintf(stderr, "context click request at (%f %f)\n", spos.x, spos.y);
 					}
 
@@ -1435,22 +1446,22 @@ void BoardView::HandleInput() {
 					ImVec2 spos = ImGui::GetMousePos();
 					ImVec2 pos  = ScreenToCoord(spos.x, spos.y);
 
-					m_needsRedraw = true;
+					m_needsRedrawSelection = true;
 
 					// threshold to within a pin's diameter of the pin center
 					// float min_dist = m_pinDiameter * 1.0f;
 					float min_dist = m_pinDiameter / 2.0f;
 					min_dist *= min_dist; // all distance squared
 					std::shared_ptr<Pin> selection = nullptr;
-					for (auto &pin : m_board->Pins()) {
-						if (BoardElementIsVisible(pin)) {
-							float dx   = pin->position.x - pos.x;
-							float dy   = pin->position.y - pos.y;
-							float dist = dx * dx + dy * dy;
-							if ((dist < (pin->diameter * pin->diameter)) && (dist < min_dist)) {
-								selection = pin;
-								min_dist  = dist;
-							}
+					auto &pins                     = m_board->Pins();
+					for (auto index : m_board->PinsOnSide(m_current_side)) {
+						auto &pin  = pins[index];
+						float dx   = pin->position.x - pos.x;
+						float dy   = pin->position.y - pos.y;
+						float dist = dx * dx + dy * dy;
+						if ((dist < (pin->diameter * pin->diameter)) && (dist < min_dist)) {
+							selection = pin;
+							min_dist  = dist;
 						}
 					}
 
@@ -1460,8 +1471,8 @@ void BoardView::HandleInput() {
 							for (auto p : m_board->Components()) {
 								p->visualmode = p->CVMNormal;
 							}
-							m_partHighlighted.resize(0);
-							m_pinHighlighted.resize(0);
+							m_partHighlighted.clear();
+							m_pinHighlighted.clear();
 						}
 						m_pinSelected->component->visualmode = m_pinSelected->component->CVMSelected;
 						m_partHighlighted.push_back(m_pinSelected->component);
@@ -1470,11 +1481,10 @@ void BoardView::HandleInput() {
 					if (m_pinSelected == nullptr) {
 						bool any_hits = false;
 
-						for (auto &part : m_board->Components()) {
-							int hit = 0;
-							//							auto p_part = part.get();
-
-							if (!BoardElementIsVisible(part)) continue;
+						auto &parts = m_board->Components();
+						for (auto index : m_board->ComponentsOnSide(m_current_side)) {
+							auto &part = parts[index];
+							int hit    = 0;
 
 							// Work out if the point is inside the hull
 							{
@@ -1491,7 +1501,7 @@ void BoardView::HandleInput() {
 							if (hit) {
 								any_hits = true;
 
-								bool partInList = contains(part, m_partHighlighted);
+								bool partInList = m_partHighlighted.contains(part);
 
 								/*
 								 * If the CTRL key isn't held down, then we have to
@@ -1502,7 +1512,7 @@ void BoardView::HandleInput() {
 										m_partHighlighted.push_back(part);
 										part->visualmode = part->CVMSelected;
 									} else {
-										remove(part, m_partHighlighted);
+										m_partHighlighted.remove(part);
 										part->visualmode = part->CVMNormal;
 									}
 
@@ -1510,8 +1520,8 @@ void BoardView::HandleInput() {
 									for (auto p : m_board->Components()) {
 										p->visualmode = p->CVMNormal;
 									}
-									m_partHighlighted.resize(0);
-									m_pinHighlighted.resize(0);
+									m_partHighlighted.clear();
+									m_pinHighlighted.clear();
 									if (!partInList) {
 										m_partHighlighted.push_back(part);
 										part->visualmode = part->CVMSelected;
@@ -1555,13 +1565,8 @@ void BoardView::HandleInput() {
 
 				} else {
 					if (!m_showContextMenu) {
-						if (AnnotationIsHovered()) {
-							m_needsRedraw        = true;
-							AnnotationWasHovered = true;
-						} else {
-							AnnotationWasHovered = false;
-							m_needsRedraw        = true;
-						}
+						// Hover feedback is drawn every frame, no need to redraw the board layers
+						AnnotationWasHovered = AnnotationIsHovered();
 					}
 				}
 
@@ -1641,8 +1646,7 @@ void BoardView::HandleInput() {
 
 		} else if (keybindings.isPressed("Search")) {
 			if (m_validBoard) {
-				m_showSearch  = true;
-				m_needsRedraw = true;
+				m_showSearch = true;
 			}
 
 		} else if (keybindings.isPressed("Clear")) {
@@ -1664,12 +1668,12 @@ void BoardView::HandleInput() {
  */
 void BoardView::ShowNetList(bool *p_open) {
 	static NetList netList(keybindings, std::bind(&BoardView::FindNet, this, std::placeholders::_1));
-	netList.Draw("Net List", p_open, m_board);
+	netList.Draw("Net List", p_open, m_board, searcher, m_boardStats);
 }
 
 void BoardView::ShowPartList(bool *p_open) {
 	static PartList partList(keybindings, std::bind(&BoardView::FindComponent, this, std::placeholders::_1));
-	partList.Draw("Part List", p_open, m_board);
+	partList.Draw("Part List", p_open, m_board, searcher);
 }
 
 void BoardView::RenderOverlay() {
@@ -1683,6 +1687,12 @@ void BoardView::RenderOverlay() {
 	if (m_showPartList) {
 		ShowPartList(&m_showPartList);
 	}
+
+	// Frame timings, recorded from the next frame on
+	profiler.enabled = m_showProfiler;
+	if (m_showProfiler) {
+		profiler.draw(&m_showProfiler);
+	}
 }
 
 /** End overlay & windows region **/
@@ -1696,35 +1706,27 @@ void BoardView::RenderOverlay() {
 
 void BoardView::CenterZoomNet(std::string netname) {
 	ImVec2 view = m_board_surface;
-	ImVec2 min, max;
-	int i = 0;
 
 	if (!config.infoPanelCenterZoomNets) return;
 
-	min.x = min.y = FLT_MAX;
-	max.x = max.y = FLT_MIN;
+	int net_index = m_board->NetIndex(netname);
+	if (net_index < 0) return;
 
-	for (auto &pin : m_board->Pins()) {
-		if (pin->net->name == netname) {
-			auto p = pin->position;
-			if (p.x < min.x) min.x = p.x;
-			if (p.y < min.y) min.y = p.y;
-			if (p.x > max.x) max.x = p.x;
-			if (p.y > max.y) max.y = p.y;
-
-			if ((config.infoPanelSelectPartsOnNet) && (pin->type != Pin::kPinTypeTestPad)) {
-				if (!contains(pin->component, m_partHighlighted)) {
-					pin->component->visualmode = pin->component->CVMSelected;
-					m_partHighlighted.push_back(pin->component);
-				}
+	if (config.infoPanelSelectPartsOnNet) {
+		for (auto &pin : m_board->Nets()[net_index]->pins) {
+			if (pin->type != Pin::kPinTypeTestPad && !m_partHighlighted.contains(pin->component)) {
+				pin->component->visualmode = pin->component->CVMSelected;
+				m_partHighlighted.push_back(pin->component);
 			}
 		}
 	}
 
-	// Bounds check!
-	if ((min.x == FLT_MAX) || (min.y == FLT_MAX) || (max.x == FLT_MIN) || (max.y == FLT_MIN)) return;
+	auto &stats = m_boardStats.net(net_index);
+	if (!stats.pins) return;
+	auto &min = stats.min;
+	auto &max = stats.max;
 
-	if (debug) fprintf(stderr, "CenterzoomNet: bbox[%d]: %0.1f %0.1f - %0.1f %0.1f\n", i, min.x, min.y, max.x, max.y);
+	if (debug) fprintf(stderr, "CenterzoomNet: bbox[%u]: %0.1f %0.1f - %0.1f %0.1f\n", stats.pins, min.x, min.y, max.x, max.y);
 
 	float dx = (max.x - min.x);
 	float dy = (max.y - min.y);
@@ -1777,14 +1779,13 @@ void BoardView::CenterZoomSearchResults(void) {
 	}
 
 	for (auto &pp : m_partHighlighted) {
-		for (auto &pn : pp->pins) {
-			auto &p = pn->position;
-			if (p.x < min.x) min.x = p.x;
-			if (p.y < min.y) min.y = p.y;
-			if (p.x > max.x) max.x = p.x;
-			if (p.y > max.y) max.y = p.y;
-			i++;
-		}
+		auto stats = m_boardStats.part(pp.get());
+		if (!stats || !stats->pins) continue;
+		if (stats->min.x < min.x) min.x = stats->min.x;
+		if (stats->min.y < min.y) min.y = stats->min.y;
+		if (stats->max.x > max.x) max.x = stats->max.x;
+		if (stats->max.y > max.y) max.y = stats->max.y;
+		i += stats->pins;
 	}
 
 	// Bounds check!
@@ -1924,8 +1925,6 @@ void BoardView::OutlineGenFillDraw(ImDrawList *draw, int ydelta, double thicknes
 
 	scanhits.reserve(20);
 
-	draw->ChannelsSetCurrent(kChannelFill);
-
 	// find the orthagonal bounding box
 	// probably can put this as a predefined
 	if (!boardMinMaxDone) {
@@ -2097,8 +2096,6 @@ void BoardView::DrawHex(ImDrawList *draw, ImVec2 c, double r, uint32_t color) {
 void BoardView::DrawOutlineSegments(ImDrawList *draw) {
 	const auto &segments = m_board->OutlineSegments();
 
-	draw->ChannelsSetCurrent(kChannelPolylines);
-
 	for (auto &segment: segments) {
 		ImVec2 spa = CoordToScreen(segment.first.x, segment.first.y);
 		ImVec2 spb = CoordToScreen(segment.second.x, segment.second.y);
@@ -2124,8 +2121,6 @@ void BoardView::DrawOutlinePoints(ImDrawList *draw) {
 		return;
 	}
 
-	draw->ChannelsSetCurrent(kChannelPolylines);
-
 	// set our initial draw point, so we can detect when we encounter it again
 	fp = *outline[0];
 
@@ -2166,6 +2161,7 @@ void BoardView::DrawOutlinePoints(ImDrawList *draw) {
 }
 
 void BoardView::DrawOutline(ImDrawList *draw) {
+	ProfileScope profile(profiler, Profiler::kDrawOutline);
 	DrawOutlineSegments(draw);
 	DrawOutlinePoints(draw);
 }
@@ -2181,31 +2177,31 @@ void BoardView::DrawNetWeb(ImDrawList *draw) {
 	if (m_pinSelected->type == Pin::kPinTypeUnkown) return;
 	if (m_pinSelected->net->is_ground) return;
 
-	for (auto &p : m_board->Pins()) {
-
-		if (p->net == m_pinSelected->net) {
-			uint32_t col = m_colors.pinNetWebColor;
-			if (!BoardElementIsVisible(p->component)) {
-				col = m_colors.pinNetWebOSColor;
-				draw->AddCircle(CoordToScreen(p->position.x, p->position.y), p->diameter * m_scale, col, 16);
-			}
-
-			draw->AddLine(CoordToScreen(m_pinSelected->position.x, m_pinSelected->position.y),
-			              CoordToScreen(p->position.x, p->position.y),
-			              ImColor(col),
-			              config.netWebThickness);
+	for (auto &p : m_pinSelected->net->pins) {
+		uint32_t col = m_colors.pinNetWebColor;
+		if (!BoardElementIsVisible(p->component)) {
+			col = m_colors.pinNetWebOSColor;
+			draw->AddCircle(CoordToScreen(p->position.x, p->position.y), p->diameter * m_scale, col, 16);
 		}
+
+		draw->AddLine(CoordToScreen(m_pinSelected->position.x, m_pinSelected->position.y),
+		              CoordToScreen(p->position.x, p->position.y),
+		              ImColor(col),
+		              config.netWebThickness);
 	}
 
 	return;
 }
 
 inline void BoardView::DrawPins(ImDrawList *draw) {
+	ProfileScope profile(profiler, Profiler::kDrawPins);
 
 	uint32_t cmask  = 0xFFFFFFFF;
 	uint32_t omask  = 0x00000000;
 	float threshold = 0;
 	auto io         = ImGui::GetIO();
+	ImDrawList *text_draw = m_drawLayers[kChannelText];
+	bool instanced        = m_pinInstancesCallback != nullptr; // shapes drawn by the renderer, see DrawBoard()
 
 	if (!config.showPins) return;
 
@@ -2227,11 +2223,23 @@ inline void BoardView::DrawPins(ImDrawList *draw) {
 	}
 	if (config.pinSizeThresholdLow > threshold) threshold = config.pinSizeThresholdLow;
 
-	draw->ChannelsSetCurrent(kChannelPins);
+	/*
+	 * Level of detail, pins too small to tell apart only add to the coverage
+	 * of a screen space density tile, the tiles get drawn once after all pins
+	 */
+	ImVec2 surface_min = ImGui::GetWindowPos(); // screen positions are absolute, the tiles start at the board window
+	int tile_size      = config.lodTileSize;
+	int tile_cols      = static_cast<int>(m_board_surface.x / tile_size) + 1;
+	int tile_rows      = static_cast<int>(m_board_surface.y / tile_size) + 1;
+	if (!instanced) m_lodTiles.assign(tile_cols * tile_rows, 0.0f);
 
 	if (m_pinSelected) DrawNetWeb(draw);
 
-	for (auto &pin : m_board->Pins()) {
+	auto &pins                = m_board->Pins();
+	auto &side_pins           = m_board->PinsOnSide(m_current_side);
+	unsigned int culled_count = 0, lod_count = 0;
+	for (auto index : side_pins) {
+		auto &pin           = pins[index];
 		float psz           = pin->diameter * m_scale;
 		uint32_t fill_color = 0xFFFF8888; // fallback fill colour
 		uint32_t text_color = m_colors.pinDefaultTextColor;
@@ -2239,16 +2247,16 @@ inline void BoardView::DrawPins(ImDrawList *draw) {
 		bool fill_pin       = false;
 		bool show_text      = false;
 		bool draw_ring      = true;
+		bool min_size       = false; // never smaller than half the font size
 
-		// continue if pin is not visible anyway
-		if (!BoardElementIsVisible(pin)) continue;
-
-		ImVec2 pos = CoordToScreen(pin->position.x, pin->position.y);
-		{
-			if (!IsVisibleScreen(pos.x, pos.y, psz, io)) continue;
-		}
-
-		if ((!m_pinSelected) && (psz < threshold)) continue;
+		/*
+		 * Pin instances are kept in board space for the renderer, which does the
+		 * clipping and size threshold itself, so only the text needs culling then
+		 */
+		ImVec2 pos  = CoordToScreen(pin->position.x, pin->position.y);
+		bool culled = !IsVisibleScreen(pos.x, pos.y, psz, io) || ((!m_pinSelected) && (psz < threshold));
+		culled_count += culled;
+		if (culled && !instanced) continue;
 
 		// color & text depending on app state & pin type
 
@@ -2256,8 +2264,9 @@ inline void BoardView::DrawPins(ImDrawList *draw) {
 			/*
 			 * Pins resulting from a net search
 			 */
-			if (contains(pin, m_pinHighlighted)) {
+			if (m_pinHighlighted.contains(pin)) {
 				if (psz < config.fontSize / 2) psz = config.fontSize / 2;
+				min_size   = true;
 				text_color = m_colors.pinSelectedTextColor;
 				fill_color = m_colors.pinSelectedFillColor;
 				color      = m_colors.pinSelectedColor;
@@ -2307,6 +2316,7 @@ inline void BoardView::DrawPins(ImDrawList *draw) {
 			// pin is on the same net as selected pin: highlight > rest
 			if (m_pinSelected && pin->net == m_pinSelected->net) {
 				if (psz < config.fontSize / 2) psz = config.fontSize / 2;
+				min_size   = true;
 				color      = m_colors.pinSameNetColor;
 				text_color = m_colors.pinSameNetTextColor;
 				fill_color = m_colors.pinSameNetFillColor;
@@ -2320,6 +2330,7 @@ inline void BoardView::DrawPins(ImDrawList *draw) {
 			// if (p_pin == m_pinSelected) {
 			if (pin == m_pinSelected) {
 				if (psz < config.fontSize / 2) psz = config.fontSize / 2;
+				min_size   = true;
 				color      = m_colors.pinSelectedColor;
 				text_color = m_colors.pinSelectedTextColor;
 				fill_color = m_colors.pinSelectedFillColor;
@@ -2369,29 +2380,60 @@ inline void BoardView::DrawPins(ImDrawList *draw) {
 			 */
 			if ((show_text) && (psz < config.fontSize / 2)) psz = config.fontSize / 2;
 
-			switch (pin->type) {
-				case Pin::kPinTypeTestPad:
-					if ((psz > 3) && (!config.slowCPU)) {
-						draw->AddCircleFilled(ImVec2(pos.x, pos.y), psz, fill_color, segments);
-						draw->AddCircle(ImVec2(pos.x, pos.y), psz, color, segments);
-					} else if (psz > threshold) {
-						draw->AddRectFilled(ImVec2(pos.x - h, pos.y - h), ImVec2(pos.x + h, pos.y + h), fill_color);
-					}
-					break;
-				default:
-					if ((psz > 3) && (psz > threshold)) {
-						if (config.pinShapeSquare || config.slowCPU) {
-							if (fill_pin)
-								draw->AddRectFilled(ImVec2(pos.x - h, pos.y - h), ImVec2(pos.x + h, pos.y + h), fill_color);
+			// Level of detail, not for pins singled out by the selection
+			if (!instanced && !min_size && !show_text && psz > threshold) {
+				if (psz < config.lodPinTileSize) {
+					int tx = std::min(std::max(static_cast<int>((pos.x - surface_min.x) / tile_size), 0), tile_cols - 1);
+					int ty = std::min(std::max(static_cast<int>((pos.y - surface_min.y) / tile_size), 0), tile_rows - 1);
+					m_lodTiles[ty * tile_cols + tx] += (4.0f * psz * psz) / (tile_size * tile_size);
+					lod_count++;
+					continue;
+				}
+				if (psz < config.lodPinSimpleSize) {
+					draw->AddRectFilled(ImVec2(pos.x - h, pos.y - h), ImVec2(pos.x + h, pos.y + h), fill_pin ? fill_color : color);
+					lod_count++;
+					continue;
+				}
+			}
+
+			if (instanced) {
+				PinInstance instance{};
+				bool testpad       = pin->type == Pin::kPinTypeTestPad;
+				instance.x         = pin->position.x;
+				instance.y         = pin->position.y;
+				instance.radius    = pin->diameter;
+				instance.minRadius = (min_size || show_text) ? config.fontSize / 2 : 0.0f;
+				instance.threshold = threshold;
+				bool square        = testpad ? config.slowCPU : (config.pinShapeSquare || config.slowCPU);
+				instance.shape     = square ? PinInstance::kShapeSquare : PinInstance::kShapeCircle;
+				if (testpad || fill_pin) instance.fill = ImGui::ColorConvertU32ToFloat4(fill_color);
+				if ((testpad && !config.slowCPU) || (!testpad && draw_ring)) instance.ring = ImGui::ColorConvertU32ToFloat4(color);
+				m_pinInstancesNext.push_back(instance);
+			} else {
+				switch (pin->type) {
+					case Pin::kPinTypeTestPad:
+						if ((psz > 3) && (!config.slowCPU)) {
+							draw->AddCircleFilled(ImVec2(pos.x, pos.y), psz, fill_color, segments);
+							draw->AddCircle(ImVec2(pos.x, pos.y), psz, color, segments);
+						} else if (psz > threshold) {
+							draw->AddRectFilled(ImVec2(pos.x - h, pos.y - h), ImVec2(pos.x + h, pos.y + h), fill_color);
+						}
+						break;
+					default:
+						if ((psz > 3) && (psz > threshold)) {
+							if (config.pinShapeSquare || config.slowCPU) {
+								if (fill_pin)
+									draw->AddRectFilled(ImVec2(pos.x - h, pos.y - h), ImVec2(pos.x + h, pos.y + h), fill_color);
+								if (draw_ring) draw->AddRect(ImVec2(pos.x - h, pos.y - h), ImVec2(pos.x + h, pos.y + h), color);
+							} else {
+								if (fill_pin) draw->AddCircleFilled(ImVec2(pos.x, pos.y), psz, fill_color, segments);
+								if (draw_ring) draw->AddCircle(ImVec2(pos.x, pos.y), psz, color, segments);
+							}
+						} else if (psz > threshold) {
+							if (fill_pin) draw->AddRectFilled(ImVec2(pos.x - h, pos.y - h), ImVec2(pos.x + h, pos.y + h), fill_color);
 							if (draw_ring) draw->AddRect(ImVec2(pos.x - h, pos.y - h), ImVec2(pos.x + h, pos.y + h), color);
-						} else {
-							if (fill_pin) draw->AddCircleFilled(ImVec2(pos.x, pos.y), psz, fill_color, segments);
-							if (draw_ring) draw->AddCircle(ImVec2(pos.x, pos.y), psz, color, segments);
 						}
-					} else if (psz > threshold) {
-						if (fill_pin) draw->AddRectFilled(ImVec2(pos.x - h, pos.y - h), ImVec2(pos.x + h, pos.y + h), fill_color);
-						if (draw_ring) draw->AddRect(ImVec2(pos.x - h, pos.y - h), ImVec2(pos.x + h, pos.y + h), color);
-					}
+				}
 			}
 
 			// if (p_pin == m_pinSelected) {
@@ -2404,11 +2446,16 @@ inline void BoardView::DrawPins(ImDrawList *draw) {
 			// config.pinHaloThickness);
 			//		}
 
+			if (culled) continue;
+
 			// Show all pin names when config.showPinName is enabled and pin diameter is above threshold or show pin name only for selected part
 			if ((config.showPinName && psz > 3) || show_text) {
-				std::string text = pin->name + "\n" + pin->net->name;
 				ImFont *font = ImGui::GetIO().Fonts->Fonts[0]; // Default font
-				ImVec2 text_size_normalized = font->CalcTextSizeA(1.0f, FLT_MAX, 0.0f, text.c_str());
+				// Cached extents at font size 1, full text is the pin name above the net name
+				const ImVec2 &pin_name_normalized = m_labels.extent(pin->name_label);
+				const ImVec2 &net_name_normalized = m_labels.extent(pin->net->name_label);
+				ImVec2 text_size_normalized(std::max(pin_name_normalized.x, net_name_normalized.x),
+				                            pin_name_normalized.y + net_name_normalized.y);
 
 				float maxfontwidth = psz * 2.125/ text_size_normalized.x; // Fit horizontally with 6.75% overflow (should still avoid colliding with neighbours)
 				maxfontwidth = std::min(Fonts::MAX_FONT_SIZE, maxfontwidth); // Clamp to try not to overflow texture size
@@ -2417,30 +2464,72 @@ inline void BoardView::DrawPins(ImDrawList *draw) {
 				float maxfontsize = std::min(maxfontwidth, maxfontheight);
 
 				// Font size for pin name only depends on height of text (rather than width of full text incl. net name) to scale to pin bounding box
-				ImVec2 size_pin_name = font->CalcTextSizeA(maxfontheight, FLT_MAX, 0.0f, pin->name.c_str());
+				ImVec2 size_pin_name(pin_name_normalized.x * maxfontheight, pin_name_normalized.y * maxfontheight);
 				// Font size for net name also depends on width of full text to avoid overflowing too much and colliding with text from other pin
-				ImVec2 size_net_name = font->CalcTextSizeA(maxfontsize, FLT_MAX, 0.0f, pin->net->name.c_str());
+				ImVec2 size_net_name(net_name_normalized.x * maxfontsize, net_name_normalized.y * maxfontsize);
 
 				// Show pin name above net name, full text is centered vertically
 				ImVec2 pos_pin_name   = ImVec2(pos.x - size_pin_name.x * 0.5f, pos.y - size_pin_name.y);
 				ImVec2 pos_net_name   = ImVec2(pos.x - size_net_name.x * 0.5f, pos.y);
 
+				// Placed after all pins, selected pin first, then highlighted ones, then larger pads
+				LabelPlacement::Label label;
+				label.force    = pin == m_pinSelected;
+				label.priority = psz + (show_text ? 1e6f : 0.0f);
+
+				LabelPlacement::Text &pin_text = label.texts[label.count++];
+				pin_text.font                  = font;
+				pin_text.size                  = maxfontheight;
+				pin_text.pos                   = pos_pin_name;
+				pin_text.color                 = text_color;
+				pin_text.text                  = pin->name.c_str();
+
+				LabelPlacement::Text &net_text = label.texts[label.count++];
+				net_text.font                  = font;
+				net_text.size                  = maxfontsize;
+				net_text.pos                   = pos_net_name;
+				net_text.color                 = text_color;
+				net_text.text                  = pin->net->name.c_str();
 				// Background rectangle
-				draw->AddRectFilled(ImVec2(pos_net_name.x - m_scale * 0.5f, pos_net_name.y), // Begining of text with slight padding
-										ImVec2(pos_net_name.x + size_net_name.x + m_scale * 0.5f, pos_net_name.y + size_net_name.y), // End of text with slight padding
-										m_colors.pinTextBackgroundColor,
-										m_scale * 0.5f/*rounding*/);
+				net_text.bgMin      = ImVec2(pos_net_name.x - m_scale * 0.5f, pos_net_name.y); // Begining of text with slight padding
+				net_text.bgMax      = ImVec2(pos_net_name.x + size_net_name.x + m_scale * 0.5f,
+				                             pos_net_name.y + size_net_name.y); // End of text with slight padding
+				net_text.bgColor    = m_colors.pinTextBackgroundColor;
+				net_text.bgRounding = m_scale * 0.5f;
 
-				draw->ChannelsSetCurrent(kChannelText);
-				draw->AddText(font, maxfontheight, pos_pin_name, text_color, pin->name.c_str());
-				draw->AddText(font, maxfontsize, pos_net_name, text_color, pin->net->name.c_str());
-				draw->ChannelsSetCurrent(kChannelPins);
+				label.min = ImVec2(std::min(pos_pin_name.x, net_text.bgMin.x), pos_pin_name.y);
+				label.max = ImVec2(std::max(pos_pin_name.x + size_pin_name.x, net_text.bgMax.x), net_text.bgMax.y);
+				m_labelPlacement.add(label);
 			}
 		}
 	}
+
+	profiler.count(Profiler::kPinsDrawn, side_pins.size() - culled_count - lod_count);
+	profiler.count(Profiler::kPinsCulled, culled_count);
+	profiler.count(Profiler::kPinsLod, lod_count);
+
+	m_labelPlacement.place(text_draw, ImGui::GetWindowPos(), m_board_surface, DPIF(4.0f), config.labelCollisionCulling);
+
+	if (instanced) return;
+
+	// Density tiles, alpha from the pin coverage of the tile, with a floor so lone pins stay visible
+	uint32_t tile_color = (m_colors.pinDefaultColor & cmask) | omask;
+	float tile_alpha    = (tile_color >> IM_COL32_A_SHIFT) & 0xFF;
+	for (int ty = 0; ty < tile_rows; ty++) {
+		for (int tx = 0; tx < tile_cols; tx++) {
+			float coverage = m_lodTiles[ty * tile_cols + tx];
+			if (coverage <= 0.0f) continue;
+			uint32_t alpha = static_cast<uint32_t>(tile_alpha * std::min(std::max(coverage, 0.25f), 1.0f));
+			draw->AddRectFilled(ImVec2(surface_min.x + tx * tile_size, surface_min.y + ty * tile_size),
+			                    ImVec2(surface_min.x + (tx + 1) * tile_size, surface_min.y + (ty + 1) * tile_size),
+			                    (tile_color & ~IM_COL32_A_MASK) | (alpha << IM_COL32_A_SHIFT));
+		}
+	}
 }
 
 inline void BoardView::DrawParts(ImDrawList *draw) {
+	ProfileScope profile(profiler, Profiler::kDrawParts);
+	unsigned int drawn_count = 0, lod_count = 0, hidden_count = 0;
 	// float psz = (float)m_pinDiameter * 0.5f * m_scale;
 	double angle;
 	double distance = 0;
@@ -2448,8 +2537,8 @@ inline void BoardView::DrawParts(ImDrawList *draw) {
 	//	int rendered   = 0;
 	char p0, p1; // first two characters of the part name, code-writing
 	             // convenience more than anything else
+	ImDrawList *text_draw = m_drawLayers[kChannelText];
 
-	draw->ChannelsSetCurrent(kChannelPolylines);
 	/*
 	 * If a pin has been selected, we mask out the colour to
 	 * enhance (relatively) the appearance of the pin(s)
@@ -2751,7 +2840,10 @@ inline void BoardView::DrawParts(ImDrawList *draw) {
 
 		} // if !outline_done
 
-		if (!BoardElementIsVisible(part) && !PartIsHighlighted(part)) continue;
+		if (!BoardElementIsVisible(part) && !PartIsHighlighted(part)) {
+			hidden_count++;
+			continue;
+		}
 
 		if (part->outline_done) {
 
@@ -2765,6 +2857,25 @@ inline void BoardView::DrawParts(ImDrawList *draw) {
 			c = ImVec2(CoordToScreen(part->outline[2].x, part->outline[2].y));
 			d = ImVec2(CoordToScreen(part->outline[3].x, part->outline[3].y));
 
+			// Find max width and height of bounding box, not perfect for non-straight bounding box but good enough
+			float minx = std::min({a.x, b.x, c.x, d.x});
+			float miny = std::min({a.y, b.y, c.y, d.y});
+			float maxx = std::max({a.x, b.x, c.x, d.x});
+			float maxy = std::max({a.y, b.y, c.y, d.y});
+
+			/*
+			 * Level of detail, from the on-screen size of the part. Small parts
+			 * only get their bounding rectangle, mid sized ones skip the hull and marks
+			 */
+			float part_size = std::max(maxx - minx, maxy - miny);
+			if (part_size < config.lodPartRectSize && !PartIsHighlighted(part)) {
+				draw->AddRect(ImVec2(minx, miny), ImVec2(maxx, maxy), color);
+				lod_count++;
+				continue;
+			}
+			bool simplified = part_size < config.lodPartSimpleSize;
+			drawn_count++;
+
 			// if (config.fillParts) draw->AddQuadFilled(a, b, c, d, color & 0xffeeeeee);
 			if (config.fillParts && !config.slowCPU) draw->AddQuadFilled(a, b, c, d, m_colors.partFillColor);
 			draw->AddQuad(a, b, c, d, color);
@@ -2776,7 +2887,7 @@ inline void BoardView::DrawParts(ImDrawList *draw) {
 			/*
 			 * Draw the convex hull of the part if it has one
 			 */
-			if (!part->hull.empty()) {
+			if (!part->hull.empty() && !simplified) {
 				draw->PathClear();
 				for (size_t i = 0; i < part->hull.size(); i++) {
 					ImVec2 p = CoordToScreen(part->hull[i].x, part->hull[i].y);
@@ -2788,7 +2899,7 @@ inline void BoardView::DrawParts(ImDrawList *draw) {
 			/*
 			 * Draw any icon/mark featuers to illustrate the part better
 			 */
-			if (part->component_type == part->kComponentTypeCapacitor) {
+			if (part->component_type == part->kComponentTypeCapacitor && !simplified) {
 				if (part->expanse > 90) {
 					int segments = trunc(part->expanse);
 					if (segments < 8) segments = 8;
@@ -2801,20 +2912,14 @@ inline void BoardView::DrawParts(ImDrawList *draw) {
 			}
 
 			if (!part->is_dummy() && !part->name.empty()) {
-				std::string text  = part->name;
+				const ImVec2 &text_size_normalized = m_labels.extent(part->name_label);
 
 				/*
 				 * Draw part name inside part bounding box
 				 */
 				if (config.showPartName) {
 					ImFont *font = ImGui::GetIO().Fonts->Fonts[0]; // Default font
-					ImVec2 text_size_normalized	= font->CalcTextSizeA(1.0f, FLT_MAX, 0.0f, text.c_str());
 
-					// Find max width and height of bounding box, not perfect for non-straight bounding box but good enough
-					float minx = std::min({a.x, b.x, c.x, d.x});
-					float miny = std::min({a.y, b.y, c.y, d.y});
-					float maxx = std::max({a.x, b.x, c.x, d.x});
-					float maxy = std::max({a.y, b.y, c.y, d.y});
 					float maxwidth = abs(maxx - minx) * 0.7; // Bounding box width with 30% padding
 					float maxheight = abs(maxy - miny) * 0.7; // Bounding box height with 30% padding
 
@@ -2831,19 +2936,31 @@ inline void BoardView::DrawParts(ImDrawList *draw) {
 					pos.x -= text_size.x * 0.5f;
 					pos.y -= text_size.y * 0.5f;
 
-					draw->ChannelsSetCurrent(kChannelText);
-					draw->AddText(font, maxfontsize, pos, m_colors.partTextColor, part->name.c_str());
-					draw->ChannelsSetCurrent(kChannelPolylines);
+					// Placed after all parts, highlighted ones first, then larger parts
+					LabelPlacement::Label label;
+					label.priority = part_size + (PartIsHighlighted(part) ? 1e6f : 0.0f);
+					label.min      = pos;
+					label.max      = ImVec2(pos.x + text_size.x, pos.y + text_size.y);
+
+					LabelPlacement::Text &text = label.texts[label.count++];
+					text.font                  = font;
+					text.size                  = maxfontsize;
+					text.pos                   = pos;
+					text.color                 = m_colors.partTextColor;
+					text.text                  = part->name.c_str();
+					m_labelPlacement.add(label);
 				}
 
 				/*
 				 * Draw the highlighted text for selected part
 				 */
 				if (PartIsHighlighted(part)) {
-					std::string mcode = part->mfgcode;
+					const std::string &mcode = part->mfgcode;
 
-					ImVec2 text_size    = ImGui::CalcTextSize(text.c_str());
-					ImVec2 mfgcode_size = ImGui::CalcTextSize(mcode.c_str());
+					float font_size     = ImGui::GetFontSize();
+					ImVec2 text_size    = ImVec2(text_size_normalized.x * font_size, text_size_normalized.y * font_size);
+					const ImVec2 &mfgcode_normalized = m_labels.extent(part->mfgcode_label);
+					ImVec2 mfgcode_size = ImVec2(mfgcode_normalized.x * font_size, mfgcode_normalized.y * font_size);
 
 					if ((!config.showInfoPanel) && (mfgcode_size.x > text_size.x)) text_size.x = mfgcode_size.x;
 
@@ -2856,28 +2973,45 @@ inline void BoardView::DrawParts(ImDrawList *draw) {
 					if (mcode.size()) pos.y -= text_size.y;
 
 					pos.x -= text_size.x * 0.5f;
-					draw->ChannelsSetCurrent(kChannelText);
 
+					// Always drawn, part names avoid it
+					LabelPlacement::Label label;
+					label.force = true;
+
+					LabelPlacement::Text &name_text = label.texts[label.count++];
+					name_text.pos                   = pos;
+					name_text.color                 = m_colors.partHighlightedTextColor;
+					name_text.text                  = part->name.c_str();
 					// This is the background of the part text.
-					draw->AddRectFilled(ImVec2(pos.x - DPIF(2.0f), pos.y - DPIF(2.0f)),
-										ImVec2(pos.x + text_size.x + DPIF(2.0f), pos.y + text_size.y + DPIF(2.0f)),
-										m_colors.partHighlightedTextBackgroundColor,
-										0.0f);
-					draw->AddText(pos, m_colors.partHighlightedTextColor, text.c_str());
+					name_text.bgMin   = ImVec2(pos.x - DPIF(2.0f), pos.y - DPIF(2.0f));
+					name_text.bgMax   = ImVec2(pos.x + text_size.x + DPIF(2.0f), pos.y + text_size.y + DPIF(2.0f));
+					name_text.bgColor = m_colors.partHighlightedTextBackgroundColor;
+					label.min         = name_text.bgMin;
+					label.max         = name_text.bgMax;
+
 					if ((!config.showInfoPanel) && (mcode.size())) {
 						//	pos.y += text_size.y;
 						pos.y += text_size.y + DPIF(2.0f);
-						draw->AddRectFilled(ImVec2(pos.x - DPIF(2.0f), pos.y - DPIF(2.0f)),
-											ImVec2(pos.x + text_size.x + DPIF(2.0f), pos.y + text_size.y + DPIF(2.0f)),
-											m_colors.annotationPopupBackgroundColor,
-											0.0f);
-						draw->AddText(ImVec2(pos.x, pos.y), m_colors.annotationPopupTextColor, mcode.c_str());
+						LabelPlacement::Text &mcode_text = label.texts[label.count++];
+						mcode_text.pos                   = pos;
+						mcode_text.color                 = m_colors.annotationPopupTextColor;
+						mcode_text.text                  = mcode.c_str();
+						mcode_text.bgMin   = ImVec2(pos.x - DPIF(2.0f), pos.y - DPIF(2.0f));
+						mcode_text.bgMax   = ImVec2(pos.x + text_size.x + DPIF(2.0f), pos.y + text_size.y + DPIF(2.0f));
+						mcode_text.bgColor = m_colors.annotationPopupBackgroundColor;
+						label.max          = mcode_text.bgMax;
 					}
-					draw->ChannelsSetCurrent(kChannelPolylines);
+					m_labelPlacement.add(label);
 				}
 			}
 		}
 	} // for each part
+
+	profiler.count(Profiler::kPartsDrawn, drawn_count);
+	profiler.count(Profiler::kPartsLod, lod_count);
+	profiler.count(Profiler::kPartsHidden, hidden_count);
+
+	m_labelPlacement.place(text_draw, ImGui::GetWindowPos(), m_board_surface, DPIF(4.0f), config.labelCollisionCulling);
 }
 
 void BoardView::DrawPartTooltips(ImDrawList *draw) {
@@ -2972,8 +3106,6 @@ void BoardView::DrawPartTooltips(ImDrawList *draw) {
 				draw->AddQuad(a, b, c, d, m_colors.partHighlightedColor, 2);
 			}
 
-			draw->ChannelsSetCurrent(kChannelAnnotations);
-
 			if (currentlyHoveredPin)
 				draw->AddCircle(CoordToScreen(currentlyHoveredPin->position.x, currentlyHoveredPin->position.y),
 				                currentlyHoveredPin->diameter * m_scale,
@@ -2999,8 +3131,6 @@ void BoardView::DrawPartTooltips(ImDrawList *draw) {
 }
 
 inline void BoardView::DrawPinTooltips(ImDrawList *draw) {
-	draw->ChannelsSetCurrent(kChannelAnnotations);
-
 	if (HighlightedPinIsHovered()) {
 		ImGui::PushStyleColor(ImGuiCol_Text, m_colors.annotationPopupTextColor);
 		ImGui::PushStyleColor(ImGuiCol_PopupBg, m_colors.annotationPopupBackgroundColor);
@@ -3015,21 +3145,42 @@ inline void BoardView::DrawPinTooltips(ImDrawList *draw) {
 }
 
 inline void BoardView::DrawAnnotations(ImDrawList *draw) {
+	ProfileScope profile(profiler, Profiler::kDrawAnnotations);
+	profiler.count(Profiler::kAnnotationsDrawn, 0);
 
 	if (!config.showAnnotations) return;
 
-	draw->ChannelsSetCurrent(kChannelAnnotations);
+	AnnotationsInScreenRect(ImVec2(0.0f, 0.0f), ImGui::GetIO().DisplaySize, m_annotationsNear);
+	profiler.count(Profiler::kAnnotationsDrawn, m_annotationsNear.size());
+	for (auto index : m_annotationsNear) {
+		auto &ann = m_annotations.annotations[index];
+		ImVec2 a, b, s;
+		if (debug) fprintf(stderr, "%d:%d:%f %f: %s\n", ann.id, ann.side, ann.x, ann.y, ann.note.c_str());
+		a = s = CoordToScreen(ann.x, ann.y);
+		a.x += DPI(config.annotationBoxOffset);
+		a.y -= DPI(config.annotationBoxOffset);
+		b = ImVec2(a.x + DPI(config.annotationBoxSize), a.y - DPI(config.annotationBoxSize));
+
+		draw->AddCircleFilled(s, DPIF(2), m_colors.annotationStalkColor, 8);
+		draw->AddRectFilled(a, b, m_colors.annotationBoxColor);
+		draw->AddRect(a, b, m_colors.annotationStalkColor);
+		draw->AddLine(s, a, m_colors.annotationStalkColor);
+	}
+}
 
-	for (auto &ann : m_annotations.annotations) {
+/*
+ * The annotation boxes themselves are cached in their own layer, only the
+ * hover tooltip needs to be redone every frame.
+ */
+inline void BoardView::DrawAnnotationTooltips(void) {
+
+	if (!config.showAnnotations || !ImGui::IsWindowHovered()) return;
+
+	for (auto index : m_annotationsHovered) {
+		if (index >= m_annotations.annotations.size()) continue; // removed since
+		auto &ann = m_annotations.annotations[index];
 		if (ann.side == m_current_side) {
-			ImVec2 a, b, s;
-			if (debug) fprintf(stderr, "%d:%d:%f %f: %s\n", ann.id, ann.side, ann.x, ann.y, ann.note.c_str());
-			a = s = CoordToScreen(ann.x, ann.y);
-			a.x += DPI(config.annotationBoxOffset);
-			a.y -= DPI(config.annotationBoxOffset);
-			b = ImVec2(a.x + DPI(config.annotationBoxSize), a.y - DPI(config.annotationBoxSize));
-
-			if ((ann.hovered == true) && (ImGui::IsWindowHovered())) {
+			if (ann.hovered == true) {
 				char buf[60];
 
 				snprintf(buf, sizeof(buf), "%s", ann.note.c_str());
@@ -3052,12 +3203,7 @@ inline void BoardView::DrawAnnotations(ImDrawList *draw) {
 
 				ImGui::EndTooltip();
 				ImGui::PopStyleColor(2);
-			} else {
 			}
-			draw->AddCircleFilled(s, DPIF(2), m_colors.annotationStalkColor, 8);
-			draw->AddRectFilled(a, b, m_colors.annotationBoxColor);
-			draw->AddRect(a, b, m_colors.annotationStalkColor);
-			draw->AddLine(s, a, m_colors.annotationStalkColor);
 		}
 	}
 }
@@ -3112,25 +3258,48 @@ bool BoardView::HighlightedPinIsHovered(void) {
 	return false;
 }
 
+/*
+ * Annotations of the current side whose box may show within the screen rectangle,
+ * looked up in the annotation grid with the board area their anchor can be in
+ */
+void BoardView::AnnotationsInScreenRect(const ImVec2 &smin, const ImVec2 &smax, std::vector<uint32_t> &out) {
+	float reach = DPI(config.annotationBoxOffset) + DPI(config.annotationBoxSize);
+	ImVec2 corners[4] = {ScreenToCoord(smin.x - reach, smin.y),
+	                     ScreenToCoord(smax.x, smin.y),
+	                     ScreenToCoord(smin.x - reach, smax.y + reach),
+	                     ScreenToCoord(smax.x, smax.y + reach)};
+	ImVec2 min = corners[0], max = corners[0];
+	for (auto &c : corners) {
+		min.x = std::min(min.x, c.x);
+		min.y = std::min(min.y, c.y);
+		max.x = std::max(max.x, c.x);
+		max.y = std::max(max.y, c.y);
+	}
+	m_annotations.Query(m_current_side, min.x, min.y, max.x, max.y, out);
+}
+
 int BoardView::AnnotationIsHovered(void) {
 	ImVec2 mp       = ImGui::GetMousePos();
 	bool is_hovered = false;
-	int i           = 0;
 
 	if (!ImGui::IsWindowHovered()) return false;
 	m_annotation_last_hovered = 0;
 
-	for (auto &ann : m_annotations.annotations) {
-		ImVec2 a = CoordToScreen(ann.x, ann.y);
+	for (auto index : m_annotationsHovered)
+		if (index < m_annotations.annotations.size()) m_annotations.annotations[index].hovered = false;
+	m_annotationsHovered.clear();
+
+	AnnotationsInScreenRect(mp, mp, m_annotationsNear);
+	for (auto index : m_annotationsNear) {
+		auto &ann = m_annotations.annotations[index];
+		ImVec2 a  = CoordToScreen(ann.x, ann.y);
 		if ((mp.x > a.x + DPI(config.annotationBoxOffset)) && (mp.x < a.x + (DPI(config.annotationBoxOffset) + DPI(config.annotationBoxSize))) &&
 		    (mp.y < a.y - DPI(config.annotationBoxOffset)) && (mp.y > a.y - (DPI(config.annotationBoxOffset) + DPI(config.annotationBoxSize)))) {
 			ann.hovered               = true;
 			is_hovered                = true;
-			m_annotation_last_hovered = i;
-		} else {
-			ann.hovered = false;
+			m_annotation_last_hovered = index;
+			m_annotationsHovered.push_back(index);
 		}
-		i++;
 	}
 
 	if (is_hovered == false) m_annotation_clicked_id = -1;
@@ -3154,40 +3323,138 @@ void BoardView::DrawSelectedPins(ImDrawList *draw) {
 	}
 }
 
+ImDrawList *BoardView::ResetDrawLayer(DrawChannel channel) {
+	ImDrawList *&layer = m_drawLayers[channel];
+	ImDrawList *draw   = ImGui::GetWindowDrawList();
+
+	if (!layer) layer = IM_NEW(ImDrawList)(ImGui::GetDrawListSharedData());
+
+	// Same texture and clip rect as the board window so the layer can be appended to its current draw command
+	layer->_ResetForNewFrame();
+	layer->PushTexture(ImGui::GetIO().Fonts->TexRef);
+	layer->PushClipRect(draw->GetClipRectMin(), draw->GetClipRectMax());
+
+	return layer;
+}
+
+void BoardView::AppendDrawLayer(ImDrawList *draw, DrawChannel channel) {
+	const ImDrawList *layer = m_drawLayers[channel];
+	if (!layer || layer->IdxBuffer.empty()) return;
+
+	/*
+	 * Command by command: indices are relative to the command's VtxOffset, a layer
+	 * over 64k vertices has several, and each keeps its clip rect and texture.
+	 * PrimReserve() starts a new VtxOffset when the window draw list would pass 64k.
+	 */
+	for (const ImDrawCmd &cmd : layer->CmdBuffer) {
+		if (cmd.UserCallback || cmd.ElemCount == 0) continue; // layers hold no callbacks
+
+		const ImDrawIdx *idx = layer->IdxBuffer.Data + cmd.IdxOffset;
+		unsigned int first   = UINT_MAX, last = 0;
+		for (unsigned int i = 0; i < cmd.ElemCount; i++) {
+			first = std::min<unsigned int>(first, idx[i]);
+			last  = std::max<unsigned int>(last, idx[i]);
+		}
+		int vtx_count = last - first + 1;
+
+		draw->PushClipRect(ImVec2(cmd.ClipRect.x, cmd.ClipRect.y), ImVec2(cmd.ClipRect.z, cmd.ClipRect.w));
+		draw->PushTexture(cmd.TexRef);
+		draw->PrimReserve(cmd.ElemCount, vtx_count);
+		memcpy(draw->_VtxWritePtr, layer->VtxBuffer.Data + cmd.VtxOffset + first, vtx_count * sizeof(ImDrawVert));
+		for (unsigned int i = 0; i < cmd.ElemCount; i++) {
+			draw->_IdxWritePtr[i] = static_cast<ImDrawIdx>(idx[i] - first + draw->_VtxCurrentIdx);
+		}
+		draw->_VtxWritePtr += vtx_count;
+		draw->_IdxWritePtr += cmd.ElemCount;
+		draw->_VtxCurrentIdx += vtx_count;
+		draw->PopTexture();
+		draw->PopClipRect();
+	}
+}
+
 void BoardView::DrawBoard() {
+	ProfileScope profile(profiler, Profiler::kDrawBoard);
 	if (!m_file || !m_board) return;
 
 	ImDrawList *draw = ImGui::GetWindowDrawList();
-	if (!m_needsRedraw) {
-		memcpy(draw, m_cachedDrawList, sizeof(ImDrawList));
-		memcpy(draw->CmdBuffer.Data, m_cachedDrawCommands.Data, m_cachedDrawCommands.Size);
-		return;
+
+	// Notes read or added by the annotation I/O thread since the last frame
+	auto &notes    = m_annotations.annotations;
+	int clicked_id = m_annotation_clicked_id >= 0 && m_annotation_clicked_id < (int)notes.size() ? notes[m_annotation_clicked_id].id : 0;
+	if (m_annotations.Poll()) {
+		m_needsRedrawAnnotations = true;
+		m_annotationsHovered.clear();
+		for (auto &a : notes) a.hovered = false;
+		if (m_annotation_clicked_id >= 0) { // the list changed under the open note, find it again
+			auto it = std::find_if(notes.begin(), notes.end(), [clicked_id](const Annotation &a) { return a.id == clicked_id; });
+			m_annotation_clicked_id = it == notes.end() ? -1 : it - notes.begin();
+		}
+	}
+
+	// Let the renderer draw the pin shapes when it can, the instances only change with the pin styles
+	ImDrawCallback pin_callback = Renderers::current ? Renderers::current->pinInstancesCallback(m_board->Pins().size()) : nullptr;
+	if (pin_callback != m_pinInstancesCallback) {
+		m_pinInstancesCallback = pin_callback;
+		m_needsRedrawSelection = true;
+	}
+	ImVec2 origin          = CoordToScreen(0.0f, 0.0f);
+	ImVec2 unit_x          = CoordToScreen(1.0f, 0.0f);
+	ImVec2 unit_y          = CoordToScreen(0.0f, 1.0f);
+	m_pinInstances.origin  = origin;
+	m_pinInstances.axisX   = ImVec2(unit_x.x - origin.x, unit_x.y - origin.y);
+	m_pinInstances.axisY   = ImVec2(unit_y.x - origin.x, unit_y.y - origin.y);
+	m_pinInstances.scale   = m_scale;
+
+	/*
+	 * Every draw channel is kept in its own layer between frames and only
+	 * tessellated again when something it depends on has changed:
+	 *   m_needsRedraw            - view, board or style change: all layers
+	 *   m_needsRedrawSelection   - selection/highlight change: outline, parts, pins and text
+	 *   m_needsRedrawAnnotations - annotation list change
+	 * Mouse hover (tooltips, halos) is drawn on top of the layers every frame.
+	 */
+	m_labels.measure(ImGui::GetIO().Fonts->Fonts[0]);
+
+	if (m_needsRedraw) {
+		m_needsRedrawSelection   = true;
+		m_needsRedrawAnnotations = true;
+		OutlineGenFillDraw(ResetDrawLayer(kChannelFill), config.boardFillSpacing, 1);
 	}
 
-	// Splitting channels, drawing onto those and merging back.
-	draw->ChannelsSplit(NUM_DRAW_CHANNELS);
+	if (m_needsRedrawSelection) {
+		ImDrawList *polylines = ResetDrawLayer(kChannelPolylines);
+		ImDrawList *pins      = ResetDrawLayer(kChannelPins);
+		ResetDrawLayer(kChannelText);
 
-	// We draw the Parts before the Pins so that we can ascertain the needed pin
-	// size for the parts based on the part/pad geometry and spacing. -Inflex
-	// OutlineGenerateFill();
-	//	DrawFill(draw);
-	OutlineGenFillDraw(draw, config.boardFillSpacing, 1);
-	DrawOutline(draw);
-	DrawParts(draw);
-	//	DrawSelectedPins(draw);
-	DrawPins(draw);
-	// DrawPinTooltips(draw);
-	DrawPartTooltips(draw);
-	DrawAnnotations(draw);
+		// We draw the Parts before the Pins so that we can ascertain the needed pin
+		// size for the parts based on the part/pad geometry and spacing. -Inflex
+		DrawOutline(polylines);
+		DrawParts(polylines);
+		//	DrawSelectedPins(pins);
+		m_pinInstancesNext.clear();
+		DrawPins(pins);
+		m_pinInstances.update(m_pinInstancesNext);
+	}
 
-	draw->ChannelsMerge();
+	if (m_needsRedrawAnnotations) DrawAnnotations(ResetDrawLayer(kChannelAnnotations));
 
-	// Copy the new draw list and cmd buffer:
-	memcpy(m_cachedDrawList, draw, sizeof(ImDrawList));
-	int cmds_size = draw->CmdBuffer.size() * sizeof(ImDrawCmd);
-	m_cachedDrawCommands.resize(cmds_size);
-	memcpy(m_cachedDrawCommands.Data, draw->CmdBuffer.Data, cmds_size);
-	m_needsRedraw = false;
+	m_needsRedraw            = false;
+	m_needsRedrawSelection   = false;
+	m_needsRedrawAnnotations = false;
+
+	for (int i = kChannelFill; i < NUM_DRAW_CHANNELS; i++) {
+		// Pin shapes go under the rest of the pins layer (net web, text backgrounds)
+		if (i == kChannelPins && m_pinInstancesCallback && !m_pinInstances.instances.empty()) {
+			draw->AddCallback(m_pinInstancesCallback, &m_pinInstances);
+			draw->AddCallback(ImDrawCallback_ResetRenderState, nullptr);
+		}
+		AppendDrawLayer(draw, static_cast<DrawChannel>(i));
+	}
+
+	ProfileScope tooltips(profiler, Profiler::kDrawTooltips);
+	// DrawPinTooltips(draw);
+	DrawPartTooltips(draw);
+	DrawAnnotationTooltips();
 }
 /** end of drawing region **/
 
@@ -3222,6 +3489,8 @@ void BoardView::CenterView(void) {
 }
 
 void BoardView::LoadBoard(BRDFileBase *file) {
+	TraceScope trace("LoadBoard");
+	m_boardStats.clear();
 	delete m_board;
 
 	// Check board outline (format) point count.
@@ -3254,9 +3523,16 @@ void BoardView::LoadBoard(BRDFileBase *file) {
 		file->format.push_back({minx, miny});
 	}
 
-	m_board = new BRDBoard(file);
-	searcher.setParts(m_board->Components());
-	searcher.setNets(m_board->Nets());
+	{
+		TraceScope trace("BRDBoard");
+		m_board = new BRDBoard(file);
+	}
+	m_boardStats.compute(m_board);
+	{
+		TraceScope trace("Search index");
+		searcher.setParts(m_board->Components());
+		searcher.setNets(m_board->Nets());
+	}
 
 	std::vector<std::string> netnames;
 	for (auto &n : m_board->Nets()) netnames.push_back(n->name);
@@ -3268,6 +3544,15 @@ void BoardView::LoadBoard(BRDFileBase *file) {
 
 	m_nets = m_board->Nets();
 
+	// Intern label strings, their extents get measured on the first draw
+	m_labels.clear();
+	for (auto &n : m_board->Nets()) n->name_label = m_labels.intern(n->name);
+	for (auto &p : m_board->Pins()) p->name_label = m_labels.intern(p->name);
+	for (auto &c : m_board->Components()) {
+		c->name_label    = m_labels.intern(c->name);
+		c->mfgcode_label = m_labels.intern(c->mfgcode);
+	}
+
 	int min_x = INT_MAX, max_x = INT_MIN, min_y = INT_MAX, max_y = INT_MIN;
 	for (auto &pa : m_board->OutlinePoints()) {
 		if (pa->x < min_x) min_x = pa->x;
@@ -3385,6 +3670,7 @@ void BoardView::Rotate(int count) {
 }
 
 void BoardView::Mirror(void) {
+	m_boardStats.clear(); // the stats job may still be reading the positions
 	auto &outline = m_board->OutlinePoints();
 	ImVec2 min, max;
 
@@ -3426,6 +3712,9 @@ void BoardView::Mirror(void) {
 	for (auto &ann : m_annotations.annotations) {
 		ann.x = max.x - ann.x;
 	}
+	m_annotations.Reindex();
+
+	m_boardStats.compute(m_board); // pin bounding boxes moved
 }
 
 void BoardView::SetTarget(float x, float y) {
@@ -3436,7 +3725,7 @@ void BoardView::SetTarget(float x, float y) {
 	m_dy += coord.y - y;
 }
 
-inline bool BoardView::BoardElementIsVisible(const std::shared_ptr<BoardElement> be) {
+inline bool BoardView::BoardElementIsVisible(const BoardElement *be) {
 	if (!be) return true; // no element? => no board side info
 
 	if (be->board_side == m_current_side) return true;
@@ -3453,7 +3742,7 @@ inline bool BoardView::IsVisibleScreen(float x, float y, float radius, const ImG
 }
 
 bool BoardView::PartIsHighlighted(const std::shared_ptr<Component> component) {
-	bool highlighted = contains(component, m_partHighlighted);
+	bool highlighted = m_partHighlighted.contains(component);
 
 	// is any pin of this part selected?
 	if (m_pinSelected) highlighted |= m_pinSelected->component == component;
@@ -3462,23 +3751,9 @@ bool BoardView::PartIsHighlighted(const std::shared_ptr<Component> component) {
 }
 
 bool BoardView::AnyItemVisible(void) {
-	bool any_visible = false;
-
-	if (m_searchComponents) {
-		for (auto &p : m_partHighlighted) {
-			any_visible |= BoardElementIsVisible(p);
-		}
-	}
-
-	if (!any_visible) {
-		if (m_searchNets) {
-			for (auto &p : m_pinHighlighted) {
-				any_visible |= BoardElementIsVisible(p->component);
-			}
-		}
-	}
-
-	return any_visible;
+	if (m_searchComponents && m_partHighlighted.visibleCount(m_current_side)) return true;
+	if (m_searchNets && m_pinHighlighted.visibleCount(m_current_side)) return true;
+	return false;
 }
 
 void BoardView::FindNetNoClear(const char *name) {
@@ -3489,11 +3764,24 @@ void BoardView::FindNetNoClear(const char *name) {
 	for (auto &net : results) {
 		for (auto &pin : net->pins) m_pinHighlighted.push_back(pin);
 	}
+	m_needsRedrawSelection = true;
+}
+
+bool BoardView::FindNetExact(const char *name) {
+	if (!m_file || !m_board || !(*name)) return false;
+
+	int net_index = m_board->NetIndex(name);
+	if (net_index < 0) return false;
+
+	for (auto &pin : m_board->Nets()[net_index]->pins) m_pinHighlighted.push_back(pin);
+	m_needsRedrawSelection = true;
+	return true;
 }
 
 void BoardView::FindNet(const char *name) {
 	m_pinHighlighted.clear();
-	FindNetNoClear(name);
+	m_needsRedrawSelection = true;
+	if (!FindNetExact(name)) FindNetNoClear(name);
 }
 
 void BoardView::FindComponentNoClear(const char *name) {
@@ -3508,7 +3796,22 @@ void BoardView::FindComponentNoClear(const char *name) {
 			m_pinHighlighted.push_back(pin);
 		}
 	}
-	m_needsRedraw = true;
+	m_needsRedrawSelection = true;
+}
+
+bool BoardView::FindComponentExact(const char *name) {
+	if (!m_file || !m_board || !(*name)) return false;
+
+	int part_index = m_board->ComponentIndex(name);
+	if (part_index < 0) return false;
+
+	auto &parts = m_board->Components();
+	for (size_t i = part_index; i < parts.size() && parts[i]->name == name; i++) {
+		m_partHighlighted.push_back(parts[i]);
+		for (auto &pin : parts[i]->pins) m_pinHighlighted.push_back(pin);
+	}
+	m_needsRedrawSelection = true;
+	return true;
 }
 
 void BoardView::FindComponent(const char *name) {
@@ -3516,8 +3819,9 @@ void BoardView::FindComponent(const char *name) {
 
 	m_pinHighlighted.clear();
 	m_partHighlighted.clear();
+	m_needsRedrawSelection = true;
 
-	FindComponentNoClear(name);
+	if (!FindComponentExact(name)) FindComponentNoClear(name);
 }
 
 void BoardView::SearchCompoundNoClear(const char *item) {
@@ -3532,6 +3836,7 @@ void BoardView::SearchCompoundNoClear(const char *item) {
 void BoardView::SearchCompound(const char *item) {
 	m_pinHighlighted.clear();
 	m_partHighlighted.clear();
+	m_needsRedrawSelection = true;
 	//	ClearAllHighlights();
 	if (*item == '\0') return;
 
@@ -3573,8 +3878,19 @@ void BoardView::HandlePDFBridgeSelection() {
 		if (selection.empty()) {
 			m_pinHighlighted.clear();
 			m_partHighlighted.clear();
+			m_needsRedrawSelection = true;
 		} else {
-			SearchCompound(selection.c_str());
+			// Selected text usually is a whole part or net name, otherwise search for it
+			m_pinHighlighted.clear();
+			m_partHighlighted.clear();
+			m_needsRedrawSelection = true;
+			bool exact             = false;
+			if (m_searchComponents) exact |= FindComponentExact(selection.c_str());
+			if (m_searchNets) exact |= FindNetExact(selection.c_str());
+			if (!exact)
+				SearchCompound(selection.c_str());
+			else if (!m_partHighlighted.empty() && !m_pinHighlighted.empty() && !AnyItemVisible())
+				FlipBoard(1); // same as SearchCompound()
 			CenterZoomSearchResults();
 		}
 	};
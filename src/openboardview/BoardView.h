@@ -1,6 +1,9 @@
 #pragma once
 
 #include "Board.h"
+#include "BoardStats.h"
+#include "HighlightSet.h"
+#include "Profiler.h"
 #include "Searcher.h"
 #include "SpellCorrector.h"
 #include "annotations.h"
@@ -16,19 +19,21 @@
 #include "GUI/Preferences/Keyboard.h"
 #include "GUI/Preferences/Program.h"
 #include "GUI/BackgroundImage.h"
+#include "GUI/LabelCache.h"
+#include "GUI/LabelPlacement.h"
 #include "GUI/Preferences/BoardSettings/BoardSettings.h"
 #include "PDFBridge/PDFBridge.h"
 #include "PDFBridge/PDFBridgeEvince.h"
 #include "PDFBridge/PDFBridgeSumatra.h"
 #include "PDFBridge/PDFFile.h"
+#include "Renderers/PinInstances.h"
 #include <cstdint>
 #include <vector>
 
 struct BRDPart;
 class BRDFile;
 
-// enum DrawChannel { kChannelImages = 0, kChannelFill, kChannelPolylines = 1, kChannelPins = 2, kChannelText = 3,
-// kChannelAnnotations = 4, NUM_DRAW_CHANNELS = 5 };
+// Board draw layers, in drawing order. Each one is cached in its own ImDrawList, see BoardView::DrawBoard()
 enum DrawChannel {
 	kChannelImages = 0,
 	kChannelFill,
@@ -49,6 +54,8 @@ struct BoardView {
 	Confparse obvconfig;
 	FHistory fhistory;
 	Searcher searcher;
+	Profiler profiler;
+	BoardStats m_boardStats;
 	SpellCorrector scnets;
 	SpellCorrector scparts;
 	KeyBindings keybindings;
@@ -88,7 +95,7 @@ struct BoardView {
 	void DrawHex(ImDrawList *draw, ImVec2 c, double r, uint32_t color);
 	void DrawBox(ImDrawList *draw, ImVec2 c, double r, uint32_t color);
 	template <class T>
-	void ShowSearchResults(std::vector<T> results, char *search, int &limit, void (BoardView::*onSelect)(const char *));
+	void ShowSearchResults(const std::vector<T> &results, char *search, int &limit, void (BoardView::*onSelect)(const char *));
 	void SearchColumnGenerate(const std::string &title,
 	                          std::pair<SharedVector<Component>, SharedVector<Net>> results,
 	                          char *search,
@@ -107,6 +114,9 @@ struct BoardView {
 	Annotations m_annotations;
 	void ContextMenu(void);
 	int AnnotationIsHovered(void);
+	void AnnotationsInScreenRect(const ImVec2 &smin, const ImVec2 &smax, std::vector<uint32_t> &out);
+	std::vector<uint32_t> m_annotationsHovered; // indices in m_annotations.annotations
+	std::vector<uint32_t> m_annotationsNear;    // query scratch
 	bool AnnotationWasHovered     = false;
 	bool m_annotationnew_retain   = false;
 	bool m_annotationedit_retain  = false;
@@ -127,13 +137,21 @@ struct BoardView {
 
 	std::shared_ptr<Pin> m_pinSelected = nullptr;
 	//	vector<Net *> m_netHiglighted;
-	SharedVector<Pin> m_pinHighlighted;
-	SharedVector<Component> m_partHighlighted;
-	char m_cachedDrawList[sizeof(ImDrawList)];
-	ImVector<char> m_cachedDrawCommands;
+	HighlightSet<Pin> m_pinHighlighted;
+	HighlightSet<Component> m_partHighlighted;
+	ImDrawList *m_drawLayers[NUM_DRAW_CHANNELS] = {};
+	// Pin shapes drawn by the renderer as instanced quads when it supports it (see DrawBoard())
+	PinInstances m_pinInstances;
+	std::vector<PinInstance> m_pinInstancesNext;
+	ImDrawCallback m_pinInstancesCallback = nullptr;
+	std::vector<float> m_lodTiles; // pin coverage of the level of detail density tiles, see DrawPins()
+	LabelCache m_labels;
+	LabelPlacement m_labelPlacement;
 	SharedVector<Net> m_nets;
 	int m_active_search_column = 0;
 	char m_search[3][128];
+	std::shared_ptr<SearchQuery> m_searchQueries[3]; // background search of each column, see SearchComponent()
+	bool m_searchHighlightPending[3] = {};           // highlight the results once the search is complete
 	char m_netFilter[128];
 	std::string m_lastFileOpenName;
 	float m_dx; // display top-right coordinate?
@@ -166,10 +184,13 @@ struct BoardView {
 	// Annotation layer specific
 	bool m_annotationsVisible = true;
 
-	// Do a hacky thing (memcpy the window draw list) to save us from rerendering
-	// the board
-	// The app will crash or break if this flag is not set when it should be.
-	bool m_needsRedraw = true;
+	// Board layers are only tessellated again when flagged dirty, otherwise the
+	// cached vertices are reused (see DrawBoard()).
+	// m_needsRedraw invalidates every layer (view, board or style change),
+	// the others only the layers depending on selection or annotations.
+	bool m_needsRedraw            = true;
+	bool m_needsRedrawSelection   = true;
+	bool m_needsRedrawAnnotations = true;
 	bool m_draggingLastFrame;
 	bool m_showContextMenu;
 	//	bool m_showNetfilterSearch;
@@ -178,6 +199,7 @@ struct BoardView {
 	bool m_searchNets       = true;
 	bool m_showNetList;
 	bool m_showPartList;
+	bool m_showProfiler = false;
 	bool m_showPreferences;
 	bool m_showColorPreferences;
 	bool m_firstFrame = true;
@@ -198,12 +220,15 @@ struct BoardView {
 	void DrawPartTooltips(ImDrawList *draw);
 	void DrawPinTooltips(ImDrawList *draw);
 	void DrawAnnotations(ImDrawList *draw);
+	void DrawAnnotationTooltips(void);
 	void DrawOutline(ImDrawList *draw);
 	void DrawOutlinePoints(ImDrawList *draw);
 	void DrawOutlineSegments(ImDrawList *draw);
 	void DrawPins(ImDrawList *draw);
 	void DrawParts(ImDrawList *draw);
 	void DrawBoard();
+	ImDrawList *ResetDrawLayer(DrawChannel channel);
+	void AppendDrawLayer(ImDrawList *draw, DrawChannel channel);
 	void DrawNetWeb(ImDrawList *draw);
 	void LoadBoard(BRDFileBase *file);
 	int LoadFile(const filesystem::path &filepath);
@@ -220,7 +245,10 @@ struct BoardView {
 
 	// Returns true if the part is shown on the currently displayed side of the
 	// board.
-	bool BoardElementIsVisible(const std::shared_ptr<BoardElement> be);
+	bool BoardElementIsVisible(const BoardElement *be);
+	template <class T> bool BoardElementIsVisible(const std::shared_ptr<T> &be) {
+		return BoardElementIsVisible(be.get());
+	}
 	bool IsVisibleScreen(float x, float y, float radius, const ImGuiIO &io);
 	// Returns true if the circle described by screen coordinates x, y, and radius
 	// is visible in the
@@ -230,13 +258,15 @@ struct BoardView {
 	bool PartIsHighlighted(const std::shared_ptr<Component> component);
 	void FindNet(const char *net);
 	void FindNetNoClear(const char *name);
+	bool FindNetExact(const char *name);
 	void FindComponent(const char *name);
 	void FindComponentNoClear(const char *name);
+	bool FindComponentExact(const char *name);
 	void SearchComponent(void);
 	void SearchNetNoClear(const char *net);
 	void SearchCompound(const char *item);
 	void SearchCompoundNoClear(const char *item);
-	std::pair<SharedVector<Component>, SharedVector<Net>> SearchPartsAndNets(const char *search, int limit);
+	void HighlightSearchResults(const std::pair<SharedVector<Component>, SharedVector<Net>> &results);
 
 	void SetLastFileOpenName(const std::string &name);
 	void FlipBoard(int mode = 0);
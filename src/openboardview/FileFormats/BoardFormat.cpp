@@ -0,0 +1,55 @@
+#include "BoardFormat.h"
+
+#include "ADFile.h"
+#include "ASCFile.h"
+#include "BDVFile.h"
+#include "BRD2File.h"
+#include "BRDAllegroFile.h"
+#include "BRDFile.h"
+#include "BVR3File.h"
+#include "BVRFile.h"
+#include "CADFile.h"
+#include "CAEFile.h"
+#include "CSTFile.h"
+#include "FZFile.h"
+#include "GenCADFile.h"
+#include "XZZPCBFile.h"
+#include "utils.h"
+
+template <class T> static BoardFormat format(const char *name) {
+	return {name, [](std::vector<char> &buf) -> BRDFileBase * { return new T(buf); }};
+}
+
+BoardFormat detectBoardFormat(const filesystem::path &filepath, std::vector<char> &buf, const BoardFileKeys &keys) {
+	if (check_fileext(filepath, ".fz")) { // Since it is encrypted we cannot use the below logic. Trust the ext.
+		return {"FZ", [keys](std::vector<char> &buf) -> BRDFileBase * {
+			        FZFile *fzfile = new FZFile();
+			        fzfile->parse(buf, keys.fz);
+			        return fzfile;
+		        }};
+	}
+	if (check_fileext(filepath, ".cae")) { // Since it is encrypted we cannot use the below logic. Trust the ext.
+		return {"CAE", [keys](std::vector<char> &buf) -> BRDFileBase * {
+			        CAEFile *caefile = new CAEFile();
+			        caefile->parse(buf, keys.cae);
+			        return caefile;
+		        }};
+	}
+	if (check_fileext(filepath, ".bom") || check_fileext(filepath, ".asc")) {
+		return {"ASC", [filepath](std::vector<char> &buf) -> BRDFileBase * { return new ASCFile(buf, filepath); }};
+	}
+	if (GenCADFile::verifyFormat(buf)) return format<GenCADFile>("GenCAD");
+	if (ADFile::verifyFormat(buf)) return format<ADFile>("AD");
+	if (CADFile::verifyFormat(buf)) return format<CADFile>("CAD");
+	if (check_fileext(filepath, ".cst")) return format<CSTFile>("CST");
+	if (BRDFile::verifyFormat(buf)) return format<BRDFile>("BRD");
+	if (BRD2File::verifyFormat(buf)) return format<BRD2File>("BRD2");
+	if (BDVFile::verifyFormat(buf)) return format<BDVFile>("BDV");
+	if (BVRFile::verifyFormat(buf)) return format<BVRFile>("BVR");
+	if (BVR3File::verifyFormat(buf)) return format<BVR3File>("BVR3");
+	if (BRDAllegroFile::verifyFormat(buf)) return format<BRDAllegroFile>("BRD Allegro");
+	if (XZZPCBFile::verifyFormat(buf)) {
+		return {"XZZPCB", [keys](std::vector<char> &buf) -> BRDFileBase * { return new XZZPCBFile(buf, keys.xzz); }};
+	}
+	return {};
+}
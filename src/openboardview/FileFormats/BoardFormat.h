@@ -0,0 +1,28 @@
+#pragma once
+
+#include <array>
+#include <cstdint>
+#include <functional>
+#include <vector>
+
+#include "BRDFileBase.h"
+
+#include "filesystem_impl.h"
+
+// Keys of the encrypted formats. With an invalid key, such as all zero, the parsers fall back to
+// their built-in key, which is empty in open source builds: such files then fail with a key error.
+struct BoardFileKeys {
+	std::array<uint32_t, 44> fz{};
+	std::array<uint32_t, 44> cae{};
+	uint64_t xzz = 0;
+};
+
+// Parser for a board file, see detectBoardFormat()
+struct BoardFormat {
+	const char *name = nullptr; // nullptr when the format was not recognized
+	std::function<BRDFileBase *(std::vector<char> &buf)> open;
+};
+
+// Pick the parser from the file content, or from its extension for the encrypted formats and ASC.
+// Detection is kept apart from parsing so that each can be timed on its own.
+BoardFormat detectBoardFormat(const filesystem::path &filepath, std::vector<char> &buf, const BoardFileKeys &keys);
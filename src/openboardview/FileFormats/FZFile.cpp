@@ -1,4 +1,5 @@
 #include "FZFile.h"
+#include "Trace.h"
 #include "utils.h"
 
 #include <algorithm>
@@ -263,6 +264,7 @@ void FZFile::parse(std::vector<char> &buf, const std::array<uint32_t, 44> &fzkey
 		 *
 		 * 1 in ~2^16 chance of a false hit.
 		 */
+		TraceScope trace("Decrypt");
 		FZFile::decode(file_buf, buffer_size); // RC6 decryption
 		                                       // fprintf(stderr,"FZFile:Decoded\n");
 	}
@@ -282,15 +284,18 @@ void FZFile::parse(std::vector<char> &buf, const std::array<uint32_t, 44> &fzkey
 
 	ENSURE_OR_FAIL(content != nullptr, error_msg, return);
 	ENSURE_OR_FAIL(content_size > 0, error_msg, return);
-	content = FZFile::decompress(content, content_size, content_size); // decompress zlib content data
-	ENSURE_OR_FAIL(content != nullptr, error_msg, return);
-	ENSURE_OR_FAIL(content_size > 0, error_msg, return);
-
-	ENSURE_OR_FAIL(content != descr, error_msg, return);
-	ENSURE_OR_FAIL(descr_size > 0, error_msg, return);
-	descr = FZFile::decompress(descr, descr_size, descr_size);
-	ENSURE_OR_FAIL(descr != nullptr, error_msg, return);
-	ENSURE_OR_FAIL(descr_size > 0, error_msg, return);
+	{
+		TraceScope trace("Inflate");
+		content = FZFile::decompress(content, content_size, content_size); // decompress zlib content data
+		ENSURE_OR_FAIL(content != nullptr, error_msg, return);
+		ENSURE_OR_FAIL(content_size > 0, error_msg, return);
+
+		ENSURE_OR_FAIL(content != descr, error_msg, return);
+		ENSURE_OR_FAIL(descr_size > 0, error_msg, return);
+		descr = FZFile::decompress(descr, descr_size, descr_size);
+		ENSURE_OR_FAIL(descr != nullptr, error_msg, return);
+		ENSURE_OR_FAIL(descr_size > 0, error_msg, return);
+	}
 
 	int current_block = 0;
 	std::unordered_map<std::string, int> parts_id; // map between part name and part number
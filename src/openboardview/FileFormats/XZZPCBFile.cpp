@@ -1,4 +1,5 @@
 #include "XZZPCBFile.h"
+#include "Trace.h"
 
 #include <algorithm>
 #include <array>
@@ -153,6 +154,7 @@ XZZPCBFile::XZZPCBFile(std::vector<char> &buf, uint64_t xzzkey) {
 	// v6v6555v6v6_found is buf.end() if not found
 	ENSURE_OR_FAIL(buf.size() >= 0x10, error_msg, return);
 	if (buf[0x10] != 0x00) {
+		TraceScope trace("Decrypt");
 		uint8_t xor_key = buf[0x10];
 		for (auto pos = buf.begin(); pos < v6v6555v6v6_found; pos++) {
 			*pos ^= xor_key; // XOR the buffer with xor_key until v6v6555v6v6 is reached
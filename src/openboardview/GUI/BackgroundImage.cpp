@@ -63,6 +63,7 @@ void BackgroundImage::writeToConfig(const filesystem::path &filepath) {
 	std::error_code ec;
 	auto confparse = Confparse{};
 	confparse.Load(filepath);
+	confparse.Begin();
 
 	auto configDir = filesystem::weakly_canonical(filepath).parent_path();
 
@@ -97,6 +98,7 @@ void BackgroundImage::writeToConfig(const filesystem::path &filepath) {
 	confparse.WriteBool("BottomImageMirrorX", bottomImage.mirrorX);
 	confparse.WriteBool("BottomImageMirrorY", bottomImage.mirrorY);
 	confparse.WriteFloat("BottomImageTransparency", bottomImage.transparency);
+	confparse.Commit();
 }
 
 std::string BackgroundImage::reload() {
@@ -267,6 +267,7 @@ void ColorScheme::readFromConfig(Confparse &obvconfig) {
 }
 
 void ColorScheme::writeToConfig(Confparse &obvconfig) {
+	obvconfig.Begin();
 	obvconfig.WriteHex("backgroundColor", byte4swap(this->backgroundColor));
 	obvconfig.WriteHex("boardFillColor", byte4swap(this->boardFillColor));
 	obvconfig.WriteHex("boardOutlineColor", byte4swap(this->boardOutlineColor));
@@ -305,4 +306,5 @@ void ColorScheme::writeToConfig(Confparse &obvconfig) {
 	obvconfig.WriteHex("orMaskPins", byte4swap(this->orMaskPins));
 	obvconfig.WriteHex("orMaskParts", byte4swap(this->orMaskParts));
 	obvconfig.WriteHex("orMaskOutline", byte4swap(this->orMaskOutline));
+	obvconfig.Commit();
 }
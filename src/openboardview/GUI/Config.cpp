@@ -84,6 +84,13 @@ void Config::readFromConfig(Confparse &obvconfig) {
 		pinShapeSquare = true;
 	}
 
+	lodPinTileSize    = obvconfig.ParseDouble("lodPinTileSize", 1.0);
+	lodPinSimpleSize  = obvconfig.ParseDouble("lodPinSimpleSize", 3.0);
+	lodPartRectSize   = obvconfig.ParseDouble("lodPartRectSize", 10.0);
+	lodPartSimpleSize = obvconfig.ParseDouble("lodPartSimpleSize", 40.0);
+	lodTileSize       = obvconfig.ParseInt("lodTileSize", 4);
+	if (lodTileSize < 1) lodTileSize = 1;
+
 
 	pinHalo          = obvconfig.ParseBool("pinHalo", true);
 	pinHaloDiameter  = obvconfig.ParseDouble("pinHaloDiameter", 1.25);
@@ -107,6 +114,7 @@ void Config::readFromConfig(Confparse &obvconfig) {
 	fillParts                 = obvconfig.ParseBool("fillParts", true);
 	showPartName              = obvconfig.ParseBool("showPartName", true);
 	showPinName               = obvconfig.ParseBool("showPinName", true);
+	labelCollisionCulling     = obvconfig.ParseBool("labelCollisionCulling", true);
 	centerZoomSearchResults = obvconfig.ParseBool("centerZoomSearchResults", true);
 	flipMode                  = obvconfig.ParseInt("flipMode", 0);
 
@@ -157,6 +165,7 @@ void Config::readFromConfig(Confparse &obvconfig) {
 }
 
 void Config::writeToConfig(Confparse &obvconfig) {
+	obvconfig.Begin();
 	obvconfig.WriteInt("dpi", dpi);
 	obvconfig.WriteInt("windowX", windowX);
 	obvconfig.WriteInt("windowY", windowY);
@@ -167,6 +176,12 @@ void Config::writeToConfig(Confparse &obvconfig) {
 	obvconfig.WriteBool("pinShapeSquare", pinShapeSquare);
 	obvconfig.WriteBool("pinShapeCircle", pinShapeCircle);
 
+	obvconfig.WriteFloat("lodPinTileSize", lodPinTileSize);
+	obvconfig.WriteFloat("lodPinSimpleSize", lodPinSimpleSize);
+	obvconfig.WriteFloat("lodPartRectSize", lodPartRectSize);
+	obvconfig.WriteFloat("lodPartSimpleSize", lodPartSimpleSize);
+	obvconfig.WriteInt("lodTileSize", lodTileSize);
+
 	obvconfig.WriteBool("pinHalo", pinHalo);
 	obvconfig.WriteFloat("pinHaloDiameter", pinHaloDiameter);
 	obvconfig.WriteFloat("pinHaloThickness", pinHaloThickness);
@@ -189,6 +204,7 @@ void Config::writeToConfig(Confparse &obvconfig) {
 	obvconfig.WriteBool("fillParts", fillParts);
 	obvconfig.WriteBool("showPartName", showPartName);
 	obvconfig.WriteBool("showPinName", showPinName);
+	obvconfig.WriteBool("labelCollisionCulling", labelCollisionCulling);
 	obvconfig.WriteBool("centerZoomSearchResults", centerZoomSearchResults);
 	obvconfig.WriteInt("flipMode", flipMode);
 
@@ -218,4 +234,5 @@ void Config::writeToConfig(Confparse &obvconfig) {
 	obvconfig.WriteStr("FZKey", FZKeyStr.c_str());
 	obvconfig.WriteStr("CAEKey", CAEKeyStr.c_str());
 	obvconfig.WriteStr("XZZPCBKey", XZZPCBKeyStr.c_str());
+	obvconfig.Commit();
 }
@@ -28,6 +28,14 @@ public:
 	int netWebThickness = 2;
 
 	float pinSizeThresholdLow = 0.0f;
+
+	// Level of detail tiers, on-screen sizes in pixels (0 disables a tier)
+	float lodPinTileSize    = 1.0f;  // pins with a smaller radius are aggregated into density tiles
+	float lodPinSimpleSize  = 3.0f;  // pins with a smaller radius are a single filled square
+	float lodPartRectSize   = 10.0f; // parts smaller than this collapse to their bounding rectangle
+	float lodPartSimpleSize = 40.0f; // parts smaller than this skip hull and marks
+	int lodTileSize         = 4;     // density tile size
+
 	bool pinShapeSquare       = false;
 	bool pinShapeCircle       = true;
 	bool pinSelectMasks       = true;
@@ -46,6 +54,7 @@ public:
 	bool boardFill            = true;
 	bool showPartName         = true;
 	bool showPinName          = true;
+	bool labelCollisionCulling = true; // drop part/pin names overlapping a higher priority one
 	int boardFillSpacing      = 3;
 	bool showPosition  = true;
 
@@ -0,0 +1,31 @@
+#include "LabelCache.h"
+
+#include <cfloat>
+
+void LabelCache::clear() {
+	ids.clear();
+	strings.clear();
+	extents.clear();
+	measured = 0;
+}
+
+uint32_t LabelCache::intern(const std::string &text) {
+	auto it = ids.emplace(text, static_cast<uint32_t>(strings.size()));
+	if (it.second) {
+		strings.push_back(&it.first->first);
+		extents.emplace_back(0.0f, 0.0f);
+	}
+	return it.first->second;
+}
+
+void LabelCache::measure(ImFont *font) {
+	if (!font) return;
+
+	for (; measured < strings.size(); measured++) {
+		extents[measured] = font->CalcTextSizeA(1.0f, FLT_MAX, 0.0f, strings[measured]->c_str());
+	}
+}
+
+void LabelCache::invalidate() {
+	measured = 0;
+}
@@ -0,0 +1,35 @@
+#ifndef _LABELCACHE_H_
+#define _LABELCACHE_H_
+
+#include <cstdint>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include "imgui/imgui.h"
+
+// Board label strings (pin, net and part names...) interned when the board is loaded,
+// with their extents measured once at font size 1.0 so label layout is just a multiplication.
+class LabelCache {
+	std::unordered_map<std::string, uint32_t> ids;
+	std::vector<const std::string *> strings; // keys of ids, indexed by id
+	std::vector<ImVec2> extents;
+	size_t measured = 0; // strings[0..measured) have valid extents
+public:
+	void clear();
+
+	// Id of text, added to the cache if not known yet
+	uint32_t intern(const std::string &text);
+
+	// Measure strings interned since the last call with font
+	void measure(ImFont *font);
+	// Font changed, measure everything again on the next measure()
+	void invalidate();
+
+	// Extent of text at font size 1.0
+	const ImVec2 &extent(uint32_t id) const {
+		return extents[id];
+	}
+};
+
+#endif
@@ -0,0 +1,80 @@
+#include "LabelPlacement.h"
+
+#include <algorithm>
+#include <numeric>
+
+// Bits x0..x1 (0-63) set
+static uint64_t bitRange(int x0, int x1) {
+	uint64_t hi = x1 >= 63 ? ~0ull : (1ull << (x1 + 1)) - 1;
+	return hi & ~((1ull << x0) - 1);
+}
+
+void LabelPlacement::add(const Label &label) {
+	labels.push_back(label);
+}
+
+bool LabelPlacement::occupied(int x0, int y0, int x1, int y1) const {
+	for (int y = y0; y <= y1; y++) {
+		const uint64_t *row = &bitmap[y * words];
+		for (int w = x0 / 64; w <= x1 / 64; w++) {
+			if (row[w] & bitRange(std::max(x0 - w * 64, 0), std::min(x1 - w * 64, 63))) return true;
+		}
+	}
+	return false;
+}
+
+void LabelPlacement::occupy(int x0, int y0, int x1, int y1) {
+	for (int y = y0; y <= y1; y++) {
+		uint64_t *row = &bitmap[y * words];
+		for (int w = x0 / 64; w <= x1 / 64; w++) {
+			row[w] |= bitRange(std::max(x0 - w * 64, 0), std::min(x1 - w * 64, 63));
+		}
+	}
+}
+
+void LabelPlacement::place(ImDrawList *draw, const ImVec2 &origin, const ImVec2 &surface, float cellSize, bool cull) {
+	if (labels.empty()) return;
+
+	if (cull) {
+		cols  = std::max(1, static_cast<int>(surface.x / cellSize) + 1);
+		rows  = std::max(1, static_cast<int>(surface.y / cellSize) + 1);
+		words = (cols + 63) / 64;
+		bitmap.assign(words * rows, 0);
+	}
+
+	order.resize(labels.size());
+	std::iota(order.begin(), order.end(), 0);
+	std::stable_sort(order.begin(), order.end(), [this](uint32_t l, uint32_t r) {
+		if (labels[l].force != labels[r].force) return labels[l].force;
+		return labels[l].priority > labels[r].priority;
+	});
+
+	for (auto i : order) {
+		const Label &label = labels[i];
+
+		if (cull) {
+			ImVec2 min(label.min.x - origin.x, label.min.y - origin.y);
+			ImVec2 max(label.max.x - origin.x, label.max.y - origin.y);
+			int x0 = static_cast<int>(min.x / cellSize);
+			int y0 = static_cast<int>(min.y / cellSize);
+			int x1 = static_cast<int>(max.x / cellSize);
+			int y1 = static_cast<int>(max.y / cellSize);
+			if (max.x >= 0.0f && max.y >= 0.0f && x0 < cols && y0 < rows) { // Partly on screen
+				x0 = std::max(x0, 0);
+				y0 = std::max(y0, 0);
+				x1 = std::min(x1, cols - 1);
+				y1 = std::min(y1, rows - 1);
+				if (!label.force && occupied(x0, y0, x1, y1)) continue;
+				occupy(x0, y0, x1, y1);
+			}
+		}
+
+		for (int t = 0; t < label.count; t++) {
+			const Text &text = label.texts[t];
+			if (text.bgColor) draw->AddRectFilled(text.bgMin, text.bgMax, text.bgColor, text.bgRounding);
+			draw->AddText(text.font, text.size, text.pos, text.color, text.text);
+		}
+	}
+
+	labels.clear();
+}
@@ -0,0 +1,48 @@
+#ifndef _LABELPLACEMENT_H_
+#define _LABELPLACEMENT_H_
+
+#include <cstdint>
+#include <vector>
+
+#include "imgui/imgui.h"
+
+// Collects board labels, then draws them by priority, dropping the ones which overlap
+// an already placed label. Overlap is tested against a coarse screen-space occupancy bitmap.
+class LabelPlacement {
+public:
+	struct Text {
+		ImFont *font      = nullptr; // nullptr: draw list font
+		float size        = 0.0f;    // 0: draw list font size
+		ImVec2 pos;
+		uint32_t color    = 0;
+		const char *text  = nullptr; // must outlive place()
+		ImVec2 bgMin, bgMax;         // background rectangle drawn under the text
+		uint32_t bgColor  = 0;       // 0: no background
+		float bgRounding  = 0.0f;
+	};
+
+	struct Label {
+		ImVec2 min, max;        // screen area covered by the label
+		float priority = 0.0f;  // higher is placed first
+		bool force     = false; // always drawn, still occupies its area
+		Text texts[2];
+		int count = 0;
+	};
+
+	void add(const Label &label);
+
+	// Draw the labels added since the last call into draw, in priority order.
+	// The bitmap covers surface from its top-left corner origin. When cull is false every label is drawn.
+	void place(ImDrawList *draw, const ImVec2 &origin, const ImVec2 &surface, float cellSize, bool cull);
+
+private:
+	std::vector<Label> labels;
+	std::vector<uint32_t> order;
+	std::vector<uint64_t> bitmap; // one bit per cell, rows of words
+	int cols = 0, rows = 0, words = 0;
+
+	bool occupied(int x0, int y0, int x1, int y1) const;
+	void occupy(int x0, int y0, int x1, int y1);
+};
+
+#endif
@@ -11,66 +11,98 @@ BoardAppearance::BoardAppearance(Confparse &obvconfig, Config &config)
 	: obvconfig(obvconfig), config(config) {
 }
 
-void BoardAppearance::render() {
+bool BoardAppearance::render() {
+	bool changed = false;
+
 	RightAlignedText("Annotation flag size", DPI(250));
 	ImGui::SameLine();
-	ImGui::InputInt("##annotationBoxSize", &config.annotationBoxSize);
+	changed |= ImGui::InputInt("##annotationBoxSize", &config.annotationBoxSize);
 
 	RightAlignedText("Annotation flag offset", DPI(250));
 	ImGui::SameLine();
-	ImGui::InputInt("##annotationBoxOffset", &config.annotationBoxOffset);
+	changed |= ImGui::InputInt("##annotationBoxOffset", &config.annotationBoxOffset);
 
 	RightAlignedText("Pin-1/A1 count threshold", DPI(250));
 	ImGui::SameLine();
 	if (ImGui::InputInt("##pinA1threshold", &config.pinA1threshold)) {
+		changed = true;
 		if (config.pinA1threshold < 1) config.pinA1threshold = 1;
 	}
 
 	RightAlignedText("Pin select masks", DPI(250));
 	ImGui::SameLine();
-	ImGui::Checkbox("##pinSelectMasks", &config.pinSelectMasks);
+	changed |= ImGui::Checkbox("##pinSelectMasks", &config.pinSelectMasks);
 
 	RightAlignedText("Pin halo", DPI(250));
 	ImGui::SameLine();
-	ImGui::Checkbox("##pinHalo", &config.pinHalo);
+	changed |= ImGui::Checkbox("##pinHalo", &config.pinHalo);
 
 	RightAlignedText("Halo diameter", DPI(250));
 	ImGui::SameLine();
-	ImGui::InputFloat("##haloDiameter", &config.pinHaloDiameter);
+	changed |= ImGui::InputFloat("##haloDiameter", &config.pinHaloDiameter);
 
 	RightAlignedText("Halo thickness", DPI(250));
 	ImGui::SameLine();
-	ImGui::InputFloat("##haloThickness", &config.pinHaloThickness);
+	changed |= ImGui::InputFloat("##haloThickness", &config.pinHaloThickness);
 
 	RightAlignedText("Show net web", DPI(250));
 	ImGui::SameLine();
-	ImGui::Checkbox("##showNetWeb", &config.showNetWeb);
+	changed |= ImGui::Checkbox("##showNetWeb", &config.showNetWeb);
 
 	RightAlignedText("Net web thickness", DPI(250));
 	ImGui::SameLine();
-	ImGui::InputInt("##netWebThickness", &config.netWebThickness);
+	changed |= ImGui::InputInt("##netWebThickness", &config.netWebThickness);
 
 	RightAlignedText("Fill parts", DPI(250));
 	ImGui::SameLine();
-	ImGui::Checkbox("##fillParts", &config.fillParts);
+	changed |= ImGui::Checkbox("##fillParts", &config.fillParts);
 
 	ImGui::SameLine();
 	RightAlignedText("Fill board", DPI(150));
 	ImGui::SameLine();
-	ImGui::Checkbox("##boardFill", &config.boardFill);
+	changed |= ImGui::Checkbox("##boardFill", &config.boardFill);
 
 	RightAlignedText("Board fill spacing", DPI(250));
 	ImGui::SameLine();
-	ImGui::InputInt("##boardFillSpacing", &config.boardFillSpacing);
+	changed |= ImGui::InputInt("##boardFillSpacing", &config.boardFillSpacing);
+
+	RightAlignedText("LOD pin tiles below", DPI(250));
+	ImGui::SameLine();
+	changed |= ImGui::InputFloat("##lodPinTileSize", &config.lodPinTileSize);
+
+	RightAlignedText("LOD simple pins below", DPI(250));
+	ImGui::SameLine();
+	changed |= ImGui::InputFloat("##lodPinSimpleSize", &config.lodPinSimpleSize);
+
+	RightAlignedText("LOD pin tile size", DPI(250));
+	ImGui::SameLine();
+	if (ImGui::InputInt("##lodTileSize", &config.lodTileSize)) {
+		changed = true;
+		if (config.lodTileSize < 1) config.lodTileSize = 1;
+	}
+
+	RightAlignedText("LOD part rectangles below", DPI(250));
+	ImGui::SameLine();
+	changed |= ImGui::InputFloat("##lodPartRectSize", &config.lodPartRectSize);
+
+	RightAlignedText("LOD simple parts below", DPI(250));
+	ImGui::SameLine();
+	changed |= ImGui::InputFloat("##lodPartSimpleSize", &config.lodPartSimpleSize);
 
 	RightAlignedText("Show parts name", DPI(250));
 	ImGui::SameLine();
-	ImGui::Checkbox("##showPartName", &config.showPartName);
+	changed |= ImGui::Checkbox("##showPartName", &config.showPartName);
 
 	ImGui::SameLine();
 	RightAlignedText("Show pins name", DPI(150));
 	ImGui::SameLine();
-	ImGui::Checkbox("##showPinName", &config.showPinName);
+	changed |= ImGui::Checkbox("##showPinName", &config.showPinName);
+
+	RightAlignedText("Hide overlapping names", DPI(250));
+	ImGui::SameLine();
+	changed |= ImGui::Checkbox("##labelCollisionCulling", &config.labelCollisionCulling);
+
+	return changed;
 }
 
 } // namespace Preferences
@@ -14,7 +14,8 @@ private:
 public:
 	BoardAppearance(Confparse &obvconfig, Config &config);
 
-	void render();
+	// true when a setting changed
+	bool render();
 };
 
 } // namespace Preferences
@@ -34,6 +34,7 @@ void Program::render() {
 	if (ImGui::BeginPopupModal("Program Preferences", &p_open, ImGuiWindowFlags_AlwaysAutoResize)) {
 		shown = false;
 		wasOpen = true;
+		bool changed = false; // board drawing settings, redrawn to show them live
 
 		int t;
 
@@ -71,6 +72,7 @@ void Program::render() {
 				t = Fonts::MAX_FONT_SIZE;
 			}
 			config.fontSize = t;
+			changed         = true;
 		}
 
 		t = config.dpi;
@@ -80,6 +82,7 @@ void Program::render() {
 			if ((t > 25) && (t < 600)) {
 				config.dpi = t;
 				setDPI(t);
+				changed = true;
 			}
 		}
 
@@ -156,11 +159,12 @@ void Program::render() {
 		if (ImGui::Checkbox("##slowCPU", &config.slowCPU)) {
 			style.AntiAliasedLines = !config.slowCPU;
 			style.AntiAliasedFill  = !config.slowCPU;
+			changed                = true;
 		}
 
 		ImGui::Separator();
 
-		boardAppearance.render();
+		changed |= boardAppearance.render();
 
 		ImGui::Separator();
 		{
@@ -242,9 +246,12 @@ void Program::render() {
 		}
 		ImGui::SameLine();
 		if (ImGui::Button("Reset")) {
-			config = Config{};
+			config  = Config{};
+			changed = true;
 		}
 
+		if (changed) boardView.m_needsRedraw = true;
+
 		ImGui::EndPopup();
 	}
 
@@ -0,0 +1,82 @@
+#ifndef _HIGHLIGHTSET_H_
+#define _HIGHLIGHTSET_H_
+
+#include "Board.h"
+
+#include <memory>
+#include <unordered_set>
+#include <vector>
+
+// Side a highlighted element is shown on, pins follow their part
+inline EBoardSide highlightSide(const Component &part) {
+	return part.board_side;
+}
+
+inline EBoardSide highlightSide(const Pin &pin) {
+	return pin.component ? pin.component->board_side : kBoardSideBoth;
+}
+
+// Highlighted parts or pins, in insertion order without duplicates.
+// Keeps a count per board side so that visibility checks need not walk the elements.
+template <class T> class HighlightSet {
+	std::vector<std::shared_ptr<T>> items;
+	std::unordered_set<const T *> members;
+	size_t sideCount[3] = {}; // indexed by EBoardSide
+
+  public:
+	typedef typename std::vector<std::shared_ptr<T>>::const_iterator const_iterator;
+
+	const_iterator begin() const {
+		return items.begin();
+	}
+	const_iterator end() const {
+		return items.end();
+	}
+	size_t size() const {
+		return items.size();
+	}
+	bool empty() const {
+		return items.empty();
+	}
+
+	void reserve(size_t count) {
+		items.reserve(count);
+		members.reserve(count);
+	}
+
+	void clear() {
+		items.clear();
+		members.clear();
+		for (auto &count : sideCount) count = 0;
+	}
+
+	bool contains(const std::shared_ptr<T> &element) const {
+		return members.count(element.get()) != 0;
+	}
+
+	void push_back(const std::shared_ptr<T> &element) {
+		if (!members.insert(element.get()).second) return;
+		items.push_back(element);
+		sideCount[highlightSide(*element)]++;
+	}
+
+	void remove(const std::shared_ptr<T> &element) {
+		if (!members.erase(element.get())) return;
+		for (auto it = items.begin(); it != items.end(); ++it) {
+			if (*it == element) {
+				using std::swap;
+				swap(*it, items.back());
+				items.pop_back();
+				break;
+			}
+		}
+		sideCount[highlightSide(*element)]--;
+	}
+
+	// Number of elements shown when looking at side
+	size_t visibleCount(int side) const {
+		return sideCount[side] + sideCount[kBoardSideBoth];
+	}
+};
+
+#endif
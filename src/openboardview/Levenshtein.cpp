@@ -0,0 +1,59 @@
+#include "Levenshtein.h"
+
+#include <algorithm>
+#include <cstring>
+#include <vector>
+
+MyersPattern::MyersPattern(const std::string &pattern) {
+	memset(peq, 0, sizeof(peq));
+	length = std::min(pattern.size(), kMaxLength);
+	for (unsigned int i = 0; i < length; i++) peq[static_cast<unsigned char>(pattern[i])] |= 1ull << i;
+	last = length ? 1ull << (length - 1) : 0;
+}
+
+/**
+ * From https://en.wikibooks.org/wiki/Algorithm_Implementation/Strings/Levenshtein_distance#C.2B.2B
+ */
+unsigned int levenshtein_dp(const std::string &s1, const std::string &s2) {
+	const std::size_t len1 = s1.size(), len2 = s2.size();
+	std::vector<unsigned int> col(len2 + 1), prevCol(len2 + 1);
+
+	for (unsigned int i = 0; i < prevCol.size(); i++) prevCol[i] = i;
+	for (unsigned int i = 0; i < len1; i++) {
+		col[0] = i + 1;
+		for (unsigned int j = 0; j < len2; j++)
+			col[j + 1] = std::min({prevCol[1 + j] + 1, col[j] + 1, prevCol[j] + (s1[i] == s2[j] ? 0 : 1)});
+		col.swap(prevCol);
+	}
+	return prevCol[len2];
+}
+
+unsigned int levenshtein_distance(const std::string &s1, const std::string &s2) {
+	const std::string &pattern = s1.size() <= s2.size() ? s1 : s2;
+	const std::string &text    = s1.size() <= s2.size() ? s2 : s1;
+	if (pattern.size() > MyersPattern::kMaxLength) return levenshtein_dp(s1, s2);
+	if (pattern.empty()) return text.size();
+
+	MyersPattern p(pattern);
+	MyersState state(p);
+	for (auto c : text) state.step(p, c);
+	return state.score;
+}
+
+unsigned int levenshtein_bounded(const std::string &s1, const std::string &s2, unsigned int bound) {
+	const std::string &pattern = s1.size() <= s2.size() ? s1 : s2;
+	const std::string &text    = s1.size() <= s2.size() ? s2 : s1;
+	if (text.size() - pattern.size() >= bound) return bound; // Distance is at least the length difference
+	if (pattern.size() > MyersPattern::kMaxLength) return std::min(levenshtein_dp(s1, s2), bound);
+	if (pattern.empty()) return text.size();
+
+	MyersPattern p(pattern);
+	MyersState state(p);
+	size_t remaining = text.size();
+	for (auto c : text) {
+		state.step(p, c);
+		remaining--;
+		if (state.score >= bound + remaining) return bound; // Each remaining character lowers it by one at most
+	}
+	return std::min(state.score, bound);
+}
@@ -0,0 +1,60 @@
+#ifndef _LEVENSHTEIN_H_
+#define _LEVENSHTEIN_H_
+
+#include <bitset>
+#include <cstdint>
+#include <string>
+
+/*
+ * Bit-parallel Levenshtein distance (Myers 1999, as formulated for edit distance by Hyyrö 2001).
+ * One 64 bit column of the DP matrix is kept as vertical deltas, so each character of the text
+ * is a handful of word operations. Only patterns up to 64 characters fit, longer ones use the DP.
+ */
+struct MyersPattern {
+	static const size_t kMaxLength = 64;
+
+	uint64_t peq[256]; // bit i set when pattern[i] is the character
+	uint64_t last;     // bit of the last pattern character
+	unsigned int length;
+
+	explicit MyersPattern(const std::string &pattern);
+};
+
+// Distance between the pattern and the text read so far
+struct MyersState {
+	uint64_t pv, mv;
+	unsigned int score;
+
+	explicit MyersState(const MyersPattern &p) : pv(~0ull), mv(0), score(p.length) {}
+
+	void step(const MyersPattern &p, unsigned char c) {
+		uint64_t eq = p.peq[c];
+		uint64_t xv = eq | mv;
+		uint64_t xh = (((eq & pv) + pv) ^ pv) | eq;
+		uint64_t ph = mv | ~(xh | pv);
+		uint64_t mh = pv & xh;
+		if (ph & p.last) score++;
+		if (mh & p.last) score--;
+		ph = (ph << 1) | 1; // Top row of the matrix is the text position, it always grows
+		mh <<= 1;
+		pv = mh | ~(xv | ph);
+		mv = ph & xv;
+	}
+
+	// Distance between the first i pattern characters and the text, column is the number of characters read
+	unsigned int prefixScore(unsigned int i, unsigned int column) const {
+		uint64_t mask = i >= 64 ? ~0ull : (1ull << i) - 1;
+		return column + std::bitset<64>(pv & mask).count() - std::bitset<64>(mv & mask).count();
+	}
+};
+
+// Textbook O(n.m) DP, any length
+unsigned int levenshtein_dp(const std::string &s1, const std::string &s2);
+
+// Bit-parallel when either string fits a pattern, DP otherwise
+unsigned int levenshtein_distance(const std::string &s1, const std::string &s2);
+
+// Distance if below bound, bound otherwise. Stops as soon as the remaining characters cannot bring it under bound.
+unsigned int levenshtein_bounded(const std::string &s1, const std::string &s2, unsigned int bound);
+
+#endif
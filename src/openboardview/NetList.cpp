@@ -1,5 +1,7 @@
 #include "NetList.h"
 
+#include <algorithm>
+
 #include "imgui/imgui.h"
 
 NetList::NetList(KeyBindings &keyBindings, TcharStringCallback cbNetSelected) : keyBindings(keyBindings) {
@@ -8,7 +10,72 @@ NetList::NetList(KeyBindings &keyBindings, TcharStringCallback cbNetSelected) :
 
 NetList::~NetList() {}
 
-void NetList::Draw(const char *title, bool *p_open, Board *board) {
+static const char *sideName(EBoardSide side) {
+	switch (side) {
+		case kBoardSideTop: return "Top";
+		case kBoardSideBottom: return "Bottom";
+		default: return "Both";
+	}
+}
+
+// Sort permutations are computed once per board, each column is then only a lookup
+void NetList::Rebuild(Board *board, Searcher &searcher, BoardStats &stats) {
+	board_      = board;
+	generation_ = searcher.generation();
+	selected_   = -1;
+	rowsDirty_  = true;
+	for (auto &s : sorted_) s.clear();
+	if (!board) return;
+
+	auto &nets   = board->Nets();
+	auto &byName = sorted_[kColumnName];
+	byName.resize(nets.size());
+	for (uint32_t i = 0; i < nets.size(); i++) byName[i] = i;
+	std::stable_sort(byName.begin(), byName.end(), [&](uint32_t a, uint32_t b) { return nets[a]->name < nets[b]->name; });
+
+	// Sort keys copied once, the comparisons then neither wait on the statistics nor chase pointers
+	struct Keys {
+		uint32_t pins;
+		EBoardSide side;
+		bool ground;
+	};
+	auto &netStats = stats.nets();
+	std::vector<Keys> keys(nets.size());
+	for (uint32_t i = 0; i < nets.size(); i++) keys[i] = {netStats[i].pins, netStats[i].side(), nets[i]->is_ground};
+
+	// Stable sorts from the name order so that equal keys stay sorted by name
+	sorted_[kColumnPins] = byName;
+	std::stable_sort(sorted_[kColumnPins].begin(), sorted_[kColumnPins].end(), [&](uint32_t a, uint32_t b) {
+		return keys[a].pins < keys[b].pins;
+	});
+	sorted_[kColumnSide] = byName;
+	std::stable_sort(sorted_[kColumnSide].begin(), sorted_[kColumnSide].end(), [&](uint32_t a, uint32_t b) {
+		return keys[a].side < keys[b].side;
+	});
+	sorted_[kColumnGround] = byName;
+	std::stable_sort(sorted_[kColumnGround].begin(), sorted_[kColumnGround].end(), [&](uint32_t a, uint32_t b) {
+		return keys[a].ground > keys[b].ground;
+	});
+}
+
+void NetList::UpdateRows(Searcher &searcher) {
+	rowsDirty_          = false;
+	const auto &ordered = sorted_[sortColumn_];
+	if (!filter_[0]) {
+		rows_ = ordered;
+	} else {
+		// Searcher ids are sorted by index, keep the column order by marking them
+		std::vector<bool> match(ordered.size());
+		for (auto id : searcher.netIds(filter_))
+			if (id < match.size()) match[id] = true;
+		rows_.clear();
+		for (auto id : ordered)
+			if (match[id]) rows_.push_back(id);
+	}
+	if (sortDescending_) std::reverse(rows_.begin(), rows_.end());
+}
+
+void NetList::Draw(const char *title, bool *p_open, Board *board, Searcher &searcher, BoardStats &stats) {
 	// TODO: export / fix dimensions & behaviour
 	int width  = 400;
 	int height = 640;
@@ -16,37 +83,64 @@ void NetList::Draw(const char *title, bool *p_open, Board *board) {
 	ImGui::SetNextWindowSize(ImVec2(width, height));
 	ImGui::Begin(title, p_open);
 
-	ImGui::Columns(1, "part_infos");
-	ImGui::Separator();
+	if (board != board_ || searcher.generation() != generation_) Rebuild(board, searcher, stats);
 
-	ImGui::Text("Name");
-	ImGui::NextColumn();
-	ImGui::Separator();
+	ImGui::SetNextItemWidth(-1.0f);
+	if (ImGui::InputTextWithHint("##filter", "Filter", filter_, sizeof(filter_))) rowsDirty_ = true;
 
-	if (board) {
-		auto nets = board->Nets();
+	if (board && ImGui::BeginTable("net_infos",
+	                               kColumnCount,
+	                               ImGuiTableFlags_Sortable | ImGuiTableFlags_ScrollY | ImGuiTableFlags_RowBg |
+	                                   ImGuiTableFlags_Resizable | ImGuiTableFlags_BordersOuter)) {
+		ImGui::TableSetupScrollFreeze(0, 1);
+		ImGui::TableSetupColumn("Name", ImGuiTableColumnFlags_DefaultSort | ImGuiTableColumnFlags_WidthStretch, 0.0f, kColumnName);
+		ImGui::TableSetupColumn("Pins", ImGuiTableColumnFlags_WidthFixed, 0.0f, kColumnPins);
+		ImGui::TableSetupColumn("Side", ImGuiTableColumnFlags_WidthFixed, 0.0f, kColumnSide);
+		ImGui::TableSetupColumn("Ground", ImGuiTableColumnFlags_WidthFixed, 0.0f, kColumnGround);
+		ImGui::TableHeadersRow();
+
+		ImGuiTableSortSpecs *specs = ImGui::TableGetSortSpecs();
+		if (specs && specs->SpecsDirty) {
+			if (specs->SpecsCount > 0) {
+				sortColumn_     = specs->Specs[0].ColumnUserID;
+				sortDescending_ = specs->Specs[0].SortDirection == ImGuiSortDirection_Descending;
+			}
+			specs->SpecsDirty = false;
+			rowsDirty_        = true;
+		}
+		if (rowsDirty_) UpdateRows(searcher);
 
-		static int selected = -1;
-		std::string net_name     = "";
+		auto &nets = board->Nets();
 		ImGuiListClipper clipper;
-		clipper.Begin(nets.size());
+		clipper.Begin(rows_.size());
 		while (clipper.Step()) {
-			for (int i = clipper.DisplayStart; i < clipper.DisplayEnd; i++) {
-				net_name = nets.at(i)->name;
-				if (ImGui::Selectable(
-					net_name.c_str(), selected == i, ImGuiSelectableFlags_SpanAllColumns | ImGuiSelectableFlags_AllowDoubleClick)) {
-					selected = i;
+			for (int row = clipper.DisplayStart; row < clipper.DisplayEnd; row++) {
+				uint32_t i = rows_[row];
+				auto &net  = nets[i];
+				auto &info = stats.net(i);
+				ImGui::TableNextRow();
+				ImGui::TableNextColumn();
+				ImGui::PushID(i);
+				if (ImGui::Selectable(net->name.c_str(),
+				                      selected_ == static_cast<int>(i),
+				                      ImGuiSelectableFlags_SpanAllColumns | ImGuiSelectableFlags_AllowDoubleClick)) {
+					selected_ = i;
 					if (ImGui::IsMouseDoubleClicked(0)) {
-						cbNetSelected_(net_name.c_str());
+						cbNetSelected_(net->name.c_str());
 					}
 				}
-				ImGui::NextColumn();
+				ImGui::PopID();
+				ImGui::TableNextColumn();
+				ImGui::Text("%u", info.pins);
+				ImGui::TableNextColumn();
+				ImGui::TextUnformatted(sideName(info.side()));
+				ImGui::TableNextColumn();
+				if (net->is_ground) ImGui::TextUnformatted("GND");
 			}
 		}
 		clipper.End();
+		ImGui::EndTable();
 	}
-	ImGui::Columns(1);
-	ImGui::Separator();
 
 	if (ImGui::IsWindowHovered() && keyBindings.isPressed("CloseDialog")) {
 		*p_open = false;
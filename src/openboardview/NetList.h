@@ -1,16 +1,39 @@
 #pragma once
 
 #include "Board.h"
+#include "BoardStats.h"
+#include "Searcher.h"
 #include "UI/Keyboard/KeyBindings.h"
 
+#include <cstdint>
+#include <vector>
+
 class NetList {
   public:
 	NetList(KeyBindings &keyBindings, TcharStringCallback cbNetSelected);
 	~NetList();
 
-	void Draw(const char *title, bool *p_open, Board *board);
+	void Draw(const char *title, bool *p_open, Board *board, Searcher &searcher, BoardStats &stats);
 
   private:
+	enum Column { kColumnName = 0, kColumnPins, kColumnSide, kColumnGround, kColumnCount };
+
 	KeyBindings	&keyBindings;
 	TcharStringCallback cbNetSelected_;
+
+	// Net indices sorted by each column, rebuilt when the board changes
+	Board *board_            = nullptr;
+	unsigned int generation_ = 0;
+	std::vector<uint32_t> sorted_[kColumnCount];
+
+	// Net indices shown, in display order
+	std::vector<uint32_t> rows_;
+	bool rowsDirty_      = true;
+	int sortColumn_      = kColumnName;
+	bool sortDescending_ = false;
+	char filter_[128]    = {};
+	int selected_        = -1;
+
+	void Rebuild(Board *board, Searcher &searcher, BoardStats &stats);
+	void UpdateRows(Searcher &searcher);
 };
@@ -11,6 +11,10 @@ std::string PDFBridge::GetSelection() const {
 	return {};
 }
 
+int PDFBridge::PollInterval() const {
+	return -1;
+}
+
 void PDFBridge::OpenDocument(const PDFFile &pdfFile) {
 }
 
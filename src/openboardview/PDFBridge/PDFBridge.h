@@ -16,6 +16,8 @@ public:
 	virtual void DocumentSearch(const std::string &str, bool wholeWordsOnly, bool caseSensitive);
 	virtual bool HasNewSelection();
 	virtual std::string GetSelection() const;
+	// Milliseconds between HasNewSelection() checks while the app is idle, -1 when the bridge wakes the main loop itself
+	virtual int PollInterval() const;
 };
 
 #endif//_PDFBRIDGE_H_
@@ -43,6 +43,11 @@ std::string PDFBridgeEvince::GetSelection() const {
 	return selection;
 }
 
+int PDFBridgeEvince::PollInterval() const {
+	// DBus signals are only dispatched by HasNewSelection(), look for them while a document is open
+	return windowProxy ? 100 : -1;
+}
+
 void PDFBridgeEvince::OpenDocument(const PDFFile &pdfFile) {
 	auto pdfPath = pdfFile.getPath();
 
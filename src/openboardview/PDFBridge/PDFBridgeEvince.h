@@ -29,6 +29,7 @@ public:
 	void DocumentSearch(const std::string &str, bool wholeWordsOnly, bool caseSensitive);
 	bool HasNewSelection();
 	std::string GetSelection() const;
+	int PollInterval() const;
 };
 
 #endif
@@ -95,10 +95,7 @@ HDDEDATA CALLBACK PDFBridgeSumatra::DdeCallback(
 				pdfBridgeSumatra.reverseSearchStr = searchStr;
 				pdfBridgeSumatra.reverseSearchStrChanged = true;
 
-				// Push event to SDL queue in order to refresh GUI
-				SDL_Event sdlEvent;
-				sdlEvent.type = SDL_USEREVENT;
-				SDL_PushEvent(&sdlEvent);
+				request_frame(); // refresh GUI
 
 				return reinterpret_cast<HDDEDATA>(DDE_FACK);
 			} else {
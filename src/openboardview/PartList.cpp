@@ -1,5 +1,7 @@
 #include "PartList.h"
 
+#include <algorithm>
+
 #include "imgui/imgui.h"
 
 PartList::PartList(KeyBindings &keyBindings, TcharStringCallback cbNetSelected) : keyBindings(keyBindings) {
@@ -8,7 +10,66 @@ PartList::PartList(KeyBindings &keyBindings, TcharStringCallback cbNetSelected)
 
 PartList::~PartList() {}
 
-void PartList::Draw(const char *title, bool *p_open, Board *board) {
+static const char *sideName(EBoardSide side) {
+	switch (side) {
+		case kBoardSideTop: return "Top";
+		case kBoardSideBottom: return "Bottom";
+		default: return "Both";
+	}
+}
+
+// Sort permutations are computed once per board, each column is then only a lookup
+void PartList::Rebuild(Board *board, Searcher &searcher) {
+	board_      = board;
+	generation_ = searcher.generation();
+	selected_   = -1;
+	rowsDirty_  = true;
+	for (auto &s : sorted_) s.clear();
+	if (!board) return;
+
+	auto &parts  = board->Components();
+	auto &byName = sorted_[kColumnName];
+	byName.resize(parts.size());
+	for (uint32_t i = 0; i < parts.size(); i++) byName[i] = i;
+	std::stable_sort(byName.begin(), byName.end(), [&](uint32_t a, uint32_t b) { return parts[a]->name < parts[b]->name; });
+
+	// Sort keys copied once, the comparisons then don't chase pointers
+	struct Keys {
+		size_t pins;
+		EBoardSide side;
+	};
+	std::vector<Keys> keys(parts.size());
+	for (uint32_t i = 0; i < parts.size(); i++) keys[i] = {parts[i]->pins.size(), parts[i]->board_side};
+
+	// Stable sorts from the name order so that equal keys stay sorted by name
+	sorted_[kColumnPins] = byName;
+	std::stable_sort(sorted_[kColumnPins].begin(), sorted_[kColumnPins].end(), [&](uint32_t a, uint32_t b) {
+		return keys[a].pins < keys[b].pins;
+	});
+	sorted_[kColumnSide] = byName;
+	std::stable_sort(sorted_[kColumnSide].begin(), sorted_[kColumnSide].end(), [&](uint32_t a, uint32_t b) {
+		return keys[a].side < keys[b].side;
+	});
+}
+
+void PartList::UpdateRows(Searcher &searcher) {
+	rowsDirty_          = false;
+	const auto &ordered = sorted_[sortColumn_];
+	if (!filter_[0]) {
+		rows_ = ordered;
+	} else {
+		// Searcher ids are sorted by index, keep the column order by marking them
+		std::vector<bool> match(ordered.size());
+		for (auto id : searcher.partIds(filter_))
+			if (id < match.size()) match[id] = true;
+		rows_.clear();
+		for (auto id : ordered)
+			if (match[id]) rows_.push_back(id);
+	}
+	if (sortDescending_) std::reverse(rows_.begin(), rows_.end());
+}
+
+void PartList::Draw(const char *title, bool *p_open, Board *board, Searcher &searcher) {
 	// TODO: export / fix dimensions & behaviour
 	int width  = 400;
 	int height = 640;
@@ -16,37 +77,60 @@ void PartList::Draw(const char *title, bool *p_open, Board *board) {
 	ImGui::SetNextWindowSize(ImVec2(width, height));
 	ImGui::Begin(title, p_open);
 
-	ImGui::Columns(1, "part_infos");
-	ImGui::Separator();
+	if (board != board_ || searcher.generation() != generation_) Rebuild(board, searcher);
 
-	ImGui::Text("Name");
-	ImGui::NextColumn();
-	ImGui::Separator();
+	ImGui::SetNextItemWidth(-1.0f);
+	if (ImGui::InputTextWithHint("##filter", "Filter", filter_, sizeof(filter_))) rowsDirty_ = true;
 
-	if (board) {
-		auto parts = board->Components();
+	if (board && ImGui::BeginTable("part_infos",
+	                               kColumnCount,
+	                               ImGuiTableFlags_Sortable | ImGuiTableFlags_ScrollY | ImGuiTableFlags_RowBg |
+	                                   ImGuiTableFlags_Resizable | ImGuiTableFlags_BordersOuter)) {
+		ImGui::TableSetupScrollFreeze(0, 1);
+		ImGui::TableSetupColumn("Name", ImGuiTableColumnFlags_DefaultSort | ImGuiTableColumnFlags_WidthStretch, 0.0f, kColumnName);
+		ImGui::TableSetupColumn("Pins", ImGuiTableColumnFlags_WidthFixed, 0.0f, kColumnPins);
+		ImGui::TableSetupColumn("Side", ImGuiTableColumnFlags_WidthFixed, 0.0f, kColumnSide);
+		ImGui::TableHeadersRow();
 
-		static int selected = -1;
-		std::string part_name    = "";
+		ImGuiTableSortSpecs *specs = ImGui::TableGetSortSpecs();
+		if (specs && specs->SpecsDirty) {
+			if (specs->SpecsCount > 0) {
+				sortColumn_     = specs->Specs[0].ColumnUserID;
+				sortDescending_ = specs->Specs[0].SortDirection == ImGuiSortDirection_Descending;
+			}
+			specs->SpecsDirty = false;
+			rowsDirty_        = true;
+		}
+		if (rowsDirty_) UpdateRows(searcher);
+
+		auto &parts = board->Components();
 		ImGuiListClipper clipper;
-		clipper.Begin(parts.size());
+		clipper.Begin(rows_.size());
 		while (clipper.Step()) {
-			for (int i = clipper.DisplayStart; i < clipper.DisplayEnd; i++) {
-				part_name = parts[i]->name;
-
-				if (ImGui::Selectable(part_name.c_str(), selected == i, ImGuiSelectableFlags_AllowDoubleClick)) {
-					selected = i;
+			for (int row = clipper.DisplayStart; row < clipper.DisplayEnd; row++) {
+				uint32_t i = rows_[row];
+				auto &part = parts[i];
+				ImGui::TableNextRow();
+				ImGui::TableNextColumn();
+				ImGui::PushID(i);
+				if (ImGui::Selectable(part->name.c_str(),
+				                      selected_ == static_cast<int>(i),
+				                      ImGuiSelectableFlags_SpanAllColumns | ImGuiSelectableFlags_AllowDoubleClick)) {
+					selected_ = i;
 					if (ImGui::IsMouseDoubleClicked(0)) {
-						cbNetSelected_(part_name.c_str());
+						cbNetSelected_(part->name.c_str());
 					}
 				}
-				ImGui::NextColumn();
+				ImGui::PopID();
+				ImGui::TableNextColumn();
+				ImGui::Text("%zu", part->pins.size());
+				ImGui::TableNextColumn();
+				ImGui::TextUnformatted(sideName(part->board_side));
 			}
 		}
 		clipper.End();
+		ImGui::EndTable();
 	}
-	ImGui::Columns(1);
-	ImGui::Separator();
 
 	if (ImGui::IsWindowHovered() && keyBindings.isPressed("CloseDialog")) {
 		*p_open = false;
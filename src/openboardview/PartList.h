@@ -1,16 +1,38 @@
 #pragma once
 
 #include "Board.h"
+#include "Searcher.h"
 #include "UI/Keyboard/KeyBindings.h"
 
+#include <cstdint>
+#include <vector>
+
 class PartList {
   public:
 	PartList(KeyBindings &keyBindings, TcharStringCallback cbNetSelected);
 	~PartList();
 
-	void Draw(const char *title, bool *p_open, Board *board);
+	void Draw(const char *title, bool *p_open, Board *board, Searcher &searcher);
 
   private:
+	enum Column { kColumnName = 0, kColumnPins, kColumnSide, kColumnCount };
+
 	KeyBindings	&keyBindings;
 	TcharStringCallback cbNetSelected_;
+
+	// Part indices sorted by each column, rebuilt when the board changes
+	Board *board_            = nullptr;
+	unsigned int generation_ = 0;
+	std::vector<uint32_t> sorted_[kColumnCount];
+
+	// Part indices shown, in display order
+	std::vector<uint32_t> rows_;
+	bool rowsDirty_      = true;
+	int sortColumn_      = kColumnName;
+	bool sortDescending_ = false;
+	char filter_[128]    = {};
+	int selected_        = -1;
+
+	void Rebuild(Board *board, Searcher &searcher);
+	void UpdateRows(Searcher &searcher);
 };
@@ -0,0 +1,136 @@
+#include "Profiler.h"
+
+#include <algorithm>
+#include <cfloat>
+#include <cstring>
+
+#include "GUI/DPI.h"
+#include "imgui/imgui.h"
+
+static const struct {
+	const char *name;
+	int depth; // nesting in the frame
+} stageInfo[Profiler::kStageCount] = {
+    {"Frame", 0},
+    {"Update", 1},
+    {"HandleInput", 2},
+    {"Search", 2},
+    {"DrawBoard", 2},
+    {"DrawOutline", 3},
+    {"DrawParts", 3},
+    {"DrawPins", 3},
+    {"DrawAnnotations", 3},
+    {"Tooltips", 3},
+    {"renderFrame", 1},
+};
+
+const char *Profiler::stageName(Stage stage) {
+	return stageInfo[stage].name;
+}
+
+void Profiler::beginFrame() {
+	m_recording = enabled;
+	if (!m_recording) {
+		m_recorded = 0; // start over when enabled again, frames are not contiguous any more
+		return;
+	}
+
+	// Element counts are only set when the layers are rebuilt, keep the last ones
+	Frame &frame = m_frames[m_current];
+	memset(frame.ms, 0, sizeof(frame.ms));
+	if (m_recorded)
+		memcpy(frame.count, m_frames[(m_current + kFrames - 1) % kFrames].count, sizeof(frame.count));
+	else
+		memset(frame.count, 0, sizeof(frame.count));
+	m_frameStart = std::chrono::steady_clock::now();
+}
+
+void Profiler::endFrame(const ImDrawData *drawData) {
+	if (!m_recording) return;
+	m_recording = false;
+
+	Frame &frame      = m_frames[m_current];
+	frame.ms[kFrame]  = std::chrono::duration<float, std::milli>(std::chrono::steady_clock::now() - m_frameStart).count();
+	unsigned int cmds = 0;
+	if (drawData) {
+		for (int i = 0; i < drawData->CmdListsCount; i++) cmds += drawData->CmdLists[i]->CmdBuffer.Size;
+		frame.count[kVertices] = drawData->TotalVtxCount;
+		frame.count[kIndices]  = drawData->TotalIdxCount;
+	}
+	frame.count[kDrawCommands] = cmds;
+
+	m_current  = (m_current + 1) % kFrames;
+	m_recorded = std::min(m_recorded + 1, kFrames);
+}
+
+void Profiler::draw(bool *p_open) {
+	ImGui::SetNextWindowSize(ImVec2(DPIF(560.0f), DPIF(480.0f)), ImGuiCond_FirstUseEver);
+	if (!ImGui::Begin("Profiler", p_open)) {
+		ImGui::End();
+		return;
+	}
+
+	if (m_recorded == 0) {
+		ImGui::TextDisabled("Waiting for frames...");
+		ImGui::End();
+		return;
+	}
+
+	ImGui::Text("Last %d frames, in ms. Frames are only rendered when something changes.", m_recorded);
+
+	struct History {
+		const Profiler *profiler;
+		int stage;
+	};
+	auto value = [](void *data, int n) {
+		auto &h = *static_cast<History *>(data);
+		return h.profiler->frame(n).ms[h.stage];
+	};
+
+	const Frame &last = frame(m_recorded - 1);
+	if (ImGui::BeginTable("##stages", 5, ImGuiTableFlags_RowBg | ImGuiTableFlags_BordersInnerV)) {
+		ImGui::TableSetupColumn("Stage", ImGuiTableColumnFlags_WidthFixed);
+		ImGui::TableSetupColumn("Last", ImGuiTableColumnFlags_WidthFixed);
+		ImGui::TableSetupColumn("Avg", ImGuiTableColumnFlags_WidthFixed);
+		ImGui::TableSetupColumn("Max", ImGuiTableColumnFlags_WidthFixed);
+		ImGui::TableSetupColumn("History", ImGuiTableColumnFlags_WidthStretch);
+		ImGui::TableHeadersRow();
+
+		for (int stage = 0; stage < kStageCount; stage++) {
+			float sum = 0.0f, max = 0.0f;
+			for (int n = 0; n < m_recorded; n++) {
+				float ms = frame(n).ms[stage];
+				sum += ms;
+				max = std::max(max, ms);
+			}
+
+			ImGui::TableNextRow();
+			ImGui::TableNextColumn();
+			ImGui::Indent(stageInfo[stage].depth * DPIF(10.0f) + 1.0f);
+			ImGui::TextUnformatted(stageInfo[stage].name);
+			ImGui::Unindent(stageInfo[stage].depth * DPIF(10.0f) + 1.0f);
+			ImGui::TableNextColumn();
+			ImGui::Text("%.2f", last.ms[stage]);
+			ImGui::TableNextColumn();
+			ImGui::Text("%.2f", sum / m_recorded);
+			ImGui::TableNextColumn();
+			ImGui::Text("%.2f", max);
+			ImGui::TableNextColumn();
+
+			History history{this, stage};
+			ImGui::PushID(stage);
+			ImGui::PlotHistogram("##history", value, &history, m_recorded, 0, nullptr, 0.0f, std::max(max, 1.0f), ImVec2(-FLT_MIN, DPIF(20.0f)));
+			ImGui::PopID();
+		}
+		ImGui::EndTable();
+	}
+
+	ImGui::Separator();
+	ImGui::Text("Pins: %u drawn, %u level of detail, %u culled", last.count[kPinsDrawn], last.count[kPinsLod], last.count[kPinsCulled]);
+	ImGui::Text("Parts: %u drawn, %u level of detail, %u on the other side", last.count[kPartsDrawn], last.count[kPartsLod], last.count[kPartsHidden]);
+	ImGui::Text("Annotations: %u drawn", last.count[kAnnotationsDrawn]);
+	ImGui::TextDisabled("(as of the last time the board layers were rebuilt)");
+	ImGui::Text("Draw lists: %u vertices, %u indices, %u commands", last.count[kVertices], last.count[kIndices], last.count[kDrawCommands]);
+
+	ImGui::End();
+}
@@ -0,0 +1,106 @@
+#ifndef _PROFILER_H_
+#define _PROFILER_H_
+
+#include <chrono>
+
+#include "Trace.h"
+
+struct ImDrawData;
+
+// Time spent in the main stages of the last frames and what they drew, for the profiler window.
+// Frames are only recorded while enabled, a ProfileScope costs two flag checks otherwise.
+// Stages also show in the Chrome trace while one is recorded, see Trace.h.
+class Profiler {
+public:
+	enum Stage {
+		kFrame,
+		kUpdate,
+		kHandleInput,
+		kSearch,
+		kDrawBoard,
+		kDrawOutline,
+		kDrawParts,
+		kDrawPins,
+		kDrawAnnotations,
+		kDrawTooltips,
+		kRenderFrame,
+		kStageCount
+	};
+	enum Counter {
+		kPinsDrawn,
+		kPinsCulled, // off screen or under the size threshold
+		kPinsLod,    // merged in a density tile or drawn as a square
+		kPartsDrawn,
+		kPartsLod, // drawn as their bounding rectangle
+		kPartsHidden,
+		kAnnotationsDrawn,
+		kVertices,
+		kIndices,
+		kDrawCommands,
+		kCounterCount
+	};
+	static const int kFrames = 240;
+
+	bool enabled = false;
+
+	void beginFrame();
+	// drawData: what the frame rendered, for the vertex, index and command counts
+	void endFrame(const ImDrawData *drawData);
+
+	bool recording() const {
+		return m_recording;
+	}
+	void add(Stage stage, float ms) {
+		if (m_recording) m_frames[m_current].ms[stage] += ms;
+	}
+	// Element counts carry over to the next frames, the board layers are not rebuilt every frame
+	void count(Counter counter, unsigned int n) {
+		if (m_recording) m_frames[m_current].count[counter] = n;
+	}
+
+	void draw(bool *p_open);
+
+	static const char *stageName(Stage stage);
+
+private:
+	struct Frame {
+		float ms[kStageCount];
+		unsigned int count[kCounterCount];
+	};
+
+	Frame m_frames[kFrames] = {};
+	int m_current  = 0; // frame being recorded
+	int m_recorded = 0; // complete frames in m_frames, up to kFrames
+	bool m_recording = false;
+	std::chrono::steady_clock::time_point m_frameStart;
+
+	// n-th complete frame, 0 being the oldest
+	const Frame &frame(int n) const {
+		return m_frames[(m_current - m_recorded + n + kFrames) % kFrames];
+	}
+};
+
+// Adds the time until the end of the scope to a stage of the current frame
+class ProfileScope {
+	Profiler &m_profiler;
+	Profiler::Stage m_stage;
+	bool m_active, m_traced;
+	std::chrono::steady_clock::time_point m_start;
+
+public:
+	ProfileScope(Profiler &profiler, Profiler::Stage stage)
+	    : m_profiler(profiler), m_stage(stage), m_active(profiler.recording()), m_traced(Trace::enabled()) {
+		if (m_active || m_traced) m_start = std::chrono::steady_clock::now();
+	}
+	~ProfileScope() {
+		if (!m_active && !m_traced) return;
+		auto end = std::chrono::steady_clock::now();
+		if (m_active) m_profiler.add(m_stage, std::chrono::duration<float, std::milli>(end - m_start).count());
+		if (m_traced) Trace::complete(Profiler::stageName(m_stage), m_start, end);
+	}
+
+	ProfileScope(const ProfileScope &) = delete;
+	ProfileScope &operator=(const ProfileScope &) = delete;
+};
+
+#endif
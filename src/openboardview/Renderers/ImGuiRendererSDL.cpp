@@ -104,6 +104,10 @@ void ImGuiRendererSDL::shutdown() {
 	ImGui_ImplSDL2_Shutdown();
 }
 
+ImDrawCallback ImGuiRendererSDL::pinInstancesCallback(size_t count) {
+	return nullptr;
+}
+
 std::string ImGuiRendererSDL::loadTextureFromFile(const filesystem::path &filepath, GLuint* out_texture, int* out_width, int* out_height)
 {
 	// Load from file
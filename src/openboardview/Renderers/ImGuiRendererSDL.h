@@ -27,6 +27,9 @@ public:
 	virtual void renderDrawData() = 0;
 	virtual void shutdown();
 
+	// ImDrawList callback drawing board pins from a PinInstances user data, nullptr if not supported for that many pins
+	virtual ImDrawCallback pinInstancesCallback(size_t count);
+
 	// Returned string is error message, empty if successful
 	virtual std::string loadTextureFromFile(const filesystem::path &filepath, GLuint* out_texture, int* out_width, int* out_height);
 protected:
@@ -2,6 +2,92 @@
 
 #include "backends/imgui_impl_opengl3.h"
 
+#include "PinInstances.h"
+
+// Instanced pin pass state, shared with the static ImDrawList callback
+struct PinPass {
+	GLuint program        = 0;
+	GLuint vao            = 0;
+	GLuint buffer         = 0;
+	GLuint texture        = 0;
+	GLint locInstances    = -1;
+	GLint locOrigin       = -1;
+	GLint locAxisX        = -1;
+	GLint locAxisY        = -1;
+	GLint locScale        = -1;
+	GLint locDisplay      = -1;
+	size_t maxInstances   = 0;
+	const PinInstances *uploaded = nullptr;
+	unsigned int uploadedGeneration = 0;
+};
+static PinPass pinPass;
+
+// One quad (4 vertex triangle strip) per instance, instance data fetched from a texture buffer
+static const char *pinVertexShader = R"(
+uniform samplerBuffer Instances;
+uniform vec2 Origin;
+uniform vec2 AxisX;
+uniform vec2 AxisY;
+uniform float Scale;
+uniform vec4 Display; // xy: display position, zw: display size
+out vec2 Frag_Offset;
+flat out float Frag_Edge;
+flat out float Frag_Shape;
+flat out vec4 Frag_Fill;
+flat out vec4 Frag_Ring;
+void main() {
+	vec4 geometry = texelFetch(Instances, gl_InstanceID * 4);
+	vec4 style    = texelFetch(Instances, gl_InstanceID * 4 + 1);
+	float radius  = max(geometry.z * Scale, geometry.w);
+	bool square   = style.y > 0.5 || radius <= 3.0;
+	Frag_Shape    = square ? 1.0 : 0.0;
+	Frag_Edge     = square ? radius * 0.5 + 0.5 : radius;
+	Frag_Fill     = texelFetch(Instances, gl_InstanceID * 4 + 2);
+	Frag_Ring     = texelFetch(Instances, gl_InstanceID * 4 + 3);
+	vec2 corner   = vec2(float(gl_VertexID & 1), float(gl_VertexID >> 1)) * 2.0 - 1.0;
+	Frag_Offset   = corner * (Frag_Edge + 1.0);
+	vec2 pos      = Origin + geometry.x * AxisX + geometry.y * AxisY + Frag_Offset;
+	vec2 ndc      = (pos - Display.xy) / Display.zw * 2.0 - 1.0;
+	gl_Position   = radius > style.x ? vec4(ndc.x, -ndc.y, 0.0, 1.0) : vec4(2.0, 2.0, 2.0, 1.0); // below threshold: outside clip volume
+}
+)";
+
+// Anti-aliased filled circle/square with a 1px ring on its edge
+static const char *pinFragmentShader = R"(
+in vec2 Frag_Offset;
+flat in float Frag_Edge;
+flat in float Frag_Shape;
+flat in vec4 Frag_Fill;
+flat in vec4 Frag_Ring;
+out vec4 Out_Color;
+void main() {
+	float d     = Frag_Shape > 0.5 ? max(abs(Frag_Offset.x), abs(Frag_Offset.y)) : length(Frag_Offset);
+	float fill  = Frag_Fill.a * clamp(Frag_Edge - d + 0.5, 0.0, 1.0);
+	float ring  = Frag_Ring.a * clamp(1.0 - abs(Frag_Edge - d), 0.0, 1.0);
+	float alpha = ring + fill * (1.0 - ring);
+	if (alpha <= 0.0) discard;
+	Out_Color = vec4((Frag_Ring.rgb * ring + Frag_Fill.rgb * fill * (1.0 - ring)) / alpha, alpha);
+}
+)";
+
+static GLuint compileShader(GLenum type, const std::string &glsl_version, const char *source) {
+	const GLchar *sources[] = {glsl_version.c_str(), "\n", source};
+	GLuint shader           = glCreateShader(type);
+	glShaderSource(shader, 3, sources, nullptr);
+	glCompileShader(shader);
+
+	GLint status = GL_FALSE;
+	glGetShaderiv(shader, GL_COMPILE_STATUS, &status);
+	if (status != GL_TRUE) {
+		char log[1024];
+		glGetShaderInfoLog(shader, sizeof(log), nullptr, log);
+		SDL_LogError(SDL_LOG_CATEGORY_RENDER, "Failed to compile pin shader: %s", log);
+		glDeleteShader(shader);
+		return 0;
+	}
+	return shader;
+}
+
 std::string ImGuiRendererSDLGL3::name() {
     return "ImGuiRendererSDLGL3";
 }
@@ -56,7 +142,11 @@ void ImGuiRendererSDLGL3::setGLVersion() {
 }
 
 bool ImGuiRendererSDLGL3::init() {
-	return ImGuiRendererSDL::init() && ImGui_ImplOpenGL3_Init(glsl_version.c_str());
+	if (!ImGuiRendererSDL::init() || !ImGui_ImplOpenGL3_Init(glsl_version.c_str())) return false;
+
+	// Not fatal, pins are then drawn by ImGui
+	if (!initPinPass()) SDL_LogWarn(SDL_LOG_CATEGORY_RENDER, "%s: instanced pin rendering disabled", this->name().c_str());
+	return true;
 }
 
 void ImGuiRendererSDLGL3::initFrame() {
@@ -69,6 +159,118 @@ void ImGuiRendererSDLGL3::renderDrawData() {
 }
 
 void ImGuiRendererSDLGL3::shutdown() {
+	shutdownPinPass();
 	ImGui_ImplOpenGL3_Shutdown();
 	ImGuiRendererSDL::shutdown();
 }
+
+ImDrawCallback ImGuiRendererSDLGL3::pinInstancesCallback(size_t count) {
+	if (!pinPass.program || count > pinPass.maxInstances) return nullptr;
+	return &ImGuiRendererSDLGL3::renderPinInstances;
+}
+
+bool ImGuiRendererSDLGL3::initPinPass() {
+#if defined(IMGUI_IMPL_OPENGL_ES2) || defined(IMGUI_IMPL_OPENGL_ES3)
+	return false; // no texture buffers
+#else
+	GLuint vs = compileShader(GL_VERTEX_SHADER, glsl_version, pinVertexShader);
+	GLuint fs = compileShader(GL_FRAGMENT_SHADER, glsl_version, pinFragmentShader);
+	if (!vs || !fs) {
+		glDeleteShader(vs);
+		glDeleteShader(fs);
+		return false;
+	}
+
+	pinPass.program = glCreateProgram();
+	glAttachShader(pinPass.program, vs);
+	glAttachShader(pinPass.program, fs);
+	glLinkProgram(pinPass.program);
+	glDetachShader(pinPass.program, vs);
+	glDetachShader(pinPass.program, fs);
+	glDeleteShader(vs);
+	glDeleteShader(fs);
+
+	GLint status = GL_FALSE;
+	glGetProgramiv(pinPass.program, GL_LINK_STATUS, &status);
+	if (status != GL_TRUE) {
+		char log[1024];
+		glGetProgramInfoLog(pinPass.program, sizeof(log), nullptr, log);
+		SDL_LogError(SDL_LOG_CATEGORY_RENDER, "Failed to link pin shader: %s", log);
+		shutdownPinPass();
+		return false;
+	}
+
+	pinPass.locInstances = glGetUniformLocation(pinPass.program, "Instances");
+	pinPass.locOrigin    = glGetUniformLocation(pinPass.program, "Origin");
+	pinPass.locAxisX     = glGetUniformLocation(pinPass.program, "AxisX");
+	pinPass.locAxisY     = glGetUniformLocation(pinPass.program, "AxisY");
+	pinPass.locScale     = glGetUniformLocation(pinPass.program, "Scale");
+	pinPass.locDisplay   = glGetUniformLocation(pinPass.program, "Display");
+
+	GLint max_texels = 0;
+	glGetIntegerv(GL_MAX_TEXTURE_BUFFER_SIZE, &max_texels);
+	pinPass.maxInstances = max_texels / (sizeof(PinInstance) / sizeof(ImVec4));
+
+	// Core profile needs a bound VAO even though the quads have no vertex attributes
+	glGenVertexArrays(1, &pinPass.vao);
+	glGenBuffers(1, &pinPass.buffer);
+	glGenTextures(1, &pinPass.texture);
+	glBindBuffer(GL_TEXTURE_BUFFER, pinPass.buffer);
+	glBindTexture(GL_TEXTURE_BUFFER, pinPass.texture);
+	glTexBuffer(GL_TEXTURE_BUFFER, GL_RGBA32F, pinPass.buffer);
+	glBindTexture(GL_TEXTURE_BUFFER, 0);
+	glBindBuffer(GL_TEXTURE_BUFFER, 0);
+
+	return true;
+#endif
+}
+
+void ImGuiRendererSDLGL3::shutdownPinPass() {
+	if (pinPass.texture) glDeleteTextures(1, &pinPass.texture);
+	if (pinPass.buffer) glDeleteBuffers(1, &pinPass.buffer);
+	if (pinPass.vao) glDeleteVertexArrays(1, &pinPass.vao);
+	if (pinPass.program) glDeleteProgram(pinPass.program);
+	pinPass = PinPass();
+}
+
+void ImGuiRendererSDLGL3::renderPinInstances(const ImDrawList *parent_list, const ImDrawCmd *cmd) {
+	const PinInstances *pins = static_cast<const PinInstances *>(cmd->UserCallbackData);
+	if (!pins || pins->instances.empty()) return;
+
+	// Instances only go to the GPU again when their content changed
+	glBindBuffer(GL_TEXTURE_BUFFER, pinPass.buffer);
+	if (pinPass.uploaded != pins || pinPass.uploadedGeneration != pins->generation) {
+		glBufferData(GL_TEXTURE_BUFFER, pins->instances.size() * sizeof(PinInstance), pins->instances.data(), GL_DYNAMIC_DRAW);
+		pinPass.uploaded           = pins;
+		pinPass.uploadedGeneration = pins->generation;
+	}
+	glBindBuffer(GL_TEXTURE_BUFFER, 0);
+
+	// Same clip rect handling as the ImGui OpenGL3 backend
+	const ImDrawData *draw_data = ImGui::GetDrawData();
+	ImVec2 clip_off             = draw_data->DisplayPos;
+	ImVec2 clip_scale           = draw_data->FramebufferScale;
+	int fb_height               = static_cast<int>(draw_data->DisplaySize.y * draw_data->FramebufferScale.y);
+	ImVec2 clip_min((cmd->ClipRect.x - clip_off.x) * clip_scale.x, (cmd->ClipRect.y - clip_off.y) * clip_scale.y);
+	ImVec2 clip_max((cmd->ClipRect.z - clip_off.x) * clip_scale.x, (cmd->ClipRect.w - clip_off.y) * clip_scale.y);
+	if (clip_max.x <= clip_min.x || clip_max.y <= clip_min.y) return;
+	glScissor(static_cast<GLint>(clip_min.x),
+	          static_cast<GLint>(fb_height - clip_max.y),
+	          static_cast<GLsizei>(clip_max.x - clip_min.x),
+	          static_cast<GLsizei>(clip_max.y - clip_min.y));
+
+	glUseProgram(pinPass.program);
+	glUniform1i(pinPass.locInstances, 0);
+	glUniform2f(pinPass.locOrigin, pins->origin.x, pins->origin.y);
+	glUniform2f(pinPass.locAxisX, pins->axisX.x, pins->axisX.y);
+	glUniform2f(pinPass.locAxisY, pins->axisY.x, pins->axisY.y);
+	glUniform1f(pinPass.locScale, pins->scale);
+	glUniform4f(pinPass.locDisplay, draw_data->DisplayPos.x, draw_data->DisplayPos.y, draw_data->DisplaySize.x, draw_data->DisplaySize.y);
+
+	glActiveTexture(GL_TEXTURE0);
+	glBindTexture(GL_TEXTURE_BUFFER, pinPass.texture);
+	glBindVertexArray(pinPass.vao);
+	glDrawArraysInstanced(GL_TRIANGLE_STRIP, 0, 4, static_cast<GLsizei>(pins->instances.size()));
+	glBindTexture(GL_TEXTURE_BUFFER, 0);
+	// The backend restores its own state through the ImDrawCallback_ResetRenderState queued after this callback
+}
@@ -13,8 +13,14 @@ public:
 	void initFrame();
 	void renderDrawData();
 	void shutdown();
+	ImDrawCallback pinInstancesCallback(size_t count);
 private:
 	std::string glsl_version;
+
+	// Instanced pin pass, see PinInstances.h
+	bool initPinPass();
+	void shutdownPinPass();
+	static void renderPinInstances(const ImDrawList *parent_list, const ImDrawCmd *cmd);
 };
 
 #endif
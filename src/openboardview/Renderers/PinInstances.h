@@ -0,0 +1,51 @@
+#ifndef _PININSTANCES_H_
+#define _PININSTANCES_H_
+
+#include <cstring>
+#include <vector>
+
+#include "imgui/imgui.h"
+
+/*
+ * Board pins handed over to the renderer as one instanced quad each, instead of
+ * tessellated ImGui circles/rectangles. Instances are stored in board coordinates
+ * so they survive pan/zoom/rotation, only the transform below changes per frame.
+ *
+ * Layout is 4 vec4 per instance, it is uploaded as is to a RGBA32F texture buffer.
+ */
+struct PinInstance {
+	enum Shape { kShapeCircle = 0, kShapeSquare = 1 };
+
+	float x, y;       // board coordinates
+	float radius;     // board units, scaled by PinInstances::scale
+	float minRadius;  // pixels, pins showing text are never drawn smaller than this
+	float threshold;  // pixels, pin is hidden when its radius is not above this
+	float shape;      // Shape, circles smaller than 3px are drawn as squares like the ImGui path
+	float padding[2];
+	ImVec4 fill;      // fill colour, alpha 0 when not filled
+	ImVec4 ring;      // 1px outline colour, alpha 0 when no ring
+};
+
+struct PinInstances {
+	std::vector<PinInstance> instances;
+	unsigned int generation = 0; // bumped when instances changed, renderer uploads them again
+
+	// Board to screen transform: screen = origin + x * axisX + y * axisY
+	ImVec2 origin{0.0f, 0.0f};
+	ImVec2 axisX{1.0f, 0.0f};
+	ImVec2 axisY{0.0f, 1.0f};
+	float scale = 1.0f;
+
+	// Replace instances with next (swapped, not copied), only invalidating the GPU copy if anything differs
+	void update(std::vector<PinInstance> &next) {
+		if (next.size() == instances.size() && (next.empty() || !memcmp(next.data(), instances.data(), next.size() * sizeof(PinInstance)))) {
+			next.clear();
+			return;
+		}
+		instances.swap(next);
+		next.clear();
+		generation++;
+	}
+};
+
+#endif
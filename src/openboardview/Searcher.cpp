@@ -1,12 +1,178 @@
 #include "platform.h"
 #include "Searcher.h"
 
+#include <algorithm>
+#include <cctype>
+#include <cstring>
+#include <functional>
+#include <numeric>
+#include <utility>
+
+std::string SearchIndex::fold(const std::string &s) {
+	std::string folded(s);
+	for (auto &c : folded) c = tolower(static_cast<unsigned char>(c));
+	return folded;
+}
+
+// Up to 3 characters packed with their count so grams of different lengths never collide
+uint32_t SearchIndex::gram(const char *s, size_t n) {
+	uint32_t g = n << 24;
+	for (size_t i = 0; i < n; i++) g |= static_cast<uint32_t>(static_cast<unsigned char>(s[i])) << (16 - 8 * i);
+	return g;
+}
+
+void SearchIndex::build(const std::vector<const std::string *> &names) {
+	m_blob.clear();
+	m_offsets.clear();
+	m_offsets.reserve(names.size() + 1);
+	for (auto name : names) {
+		m_offsets.push_back(m_blob.size());
+		m_blob += fold(*name);
+		m_blob.push_back('\0');
+	}
+	m_offsets.push_back(m_blob.size());
+
+	m_sorted.resize(names.size());
+	std::iota(m_sorted.begin(), m_sorted.end(), 0);
+	std::sort(m_sorted.begin(), m_sorted.end(), [this](uint32_t a, uint32_t b) {
+		int cmp = strcmp(name(a), name(b));
+		return cmp < 0 || (cmp == 0 && a < b);
+	});
+
+	// (gram, id) pairs sorted by gram then id, packed into a posting list per gram
+	std::vector<std::pair<uint32_t, uint32_t>> pairs;
+	for (uint32_t id = 0; id < names.size(); id++) {
+		const char *s = name(id);
+		size_t len    = nameSize(id);
+		for (size_t n = 1; n <= 3; n++) {
+			for (size_t i = 0; i + n <= len; i++) pairs.emplace_back(gram(s + i, n), id);
+		}
+	}
+	std::sort(pairs.begin(), pairs.end());
+	pairs.erase(std::unique(pairs.begin(), pairs.end()), pairs.end());
+
+	m_grams.clear();
+	m_gramStart.clear();
+	m_postings.clear();
+	m_postings.reserve(pairs.size());
+	for (auto &p : pairs) {
+		if (m_grams.empty() || m_grams.back() != p.first) {
+			m_grams.push_back(p.first);
+			m_gramStart.push_back(m_postings.size());
+		}
+		m_postings.push_back(p.second);
+	}
+	m_gramStart.push_back(m_postings.size());
+}
+
+bool SearchIndex::postings(uint32_t g, const uint32_t *&begin, const uint32_t *&end) const {
+	auto it = std::lower_bound(m_grams.begin(), m_grams.end(), g);
+	if (it == m_grams.end() || *it != g) return false;
+	size_t i = it - m_grams.begin();
+	begin    = m_postings.data() + m_gramStart[i];
+	end      = m_postings.data() + m_gramStart[i + 1];
+	return true;
+}
+
+void SearchIndex::find(const std::string &needle, SearchMode mode, std::vector<uint32_t> &ids) const {
+	ids.clear();
+	size_t n = needle.size();
+	if (n == 0) return;
+
+	if (mode == SearchMode::Sub) {
+		const uint32_t *begin, *end;
+		if (n <= 3) { // Every item containing the gram matches
+			if (postings(gram(needle.c_str(), n), begin, end)) ids.assign(begin, end);
+			return;
+		}
+
+		// Verify the items of the rarest trigram of needle
+		const uint32_t *best_begin = nullptr, *best_end = nullptr;
+		for (size_t i = 0; i + 3 <= n; i++) {
+			if (!postings(gram(needle.c_str() + i, 3), begin, end)) return; // No item has this trigram
+			if (!best_begin || end - begin < best_end - best_begin) {
+				best_begin = begin;
+				best_end   = end;
+			}
+		}
+		for (auto id = best_begin; id != best_end; id++) {
+			if (nameSize(*id) >= n && strstr(name(*id), needle.c_str())) ids.push_back(*id);
+		}
+		return;
+	}
+
+	// Prefix/Whole: matching names are contiguous in the sorted array
+	auto it = std::lower_bound(
+	    m_sorted.begin(), m_sorted.end(), needle, [this](uint32_t id, const std::string &s) { return strcmp(name(id), s.c_str()) < 0; });
+	for (; it != m_sorted.end() && !strncmp(name(*it), needle.c_str(), n); ++it) {
+		if (mode == SearchMode::Whole && nameSize(*it) != n) break; // Longer names sort after the exact ones
+		ids.push_back(*it);
+	}
+	std::sort(ids.begin(), ids.end()); // Back to board order
+}
+
+bool SearchIndex::matches(uint32_t id, const std::string &needle, SearchMode mode) const {
+	switch (mode) {
+		case SearchMode::Sub: return strstr(name(id), needle.c_str()) != nullptr;
+		case SearchMode::Prefix: return !strncmp(name(id), needle.c_str(), needle.size());
+		case SearchMode::Whole: return nameSize(id) == needle.size() && !strcmp(name(id), needle.c_str());
+	}
+	return false;
+}
+
+bool SearchTable::detailsMatch(uint32_t id, const std::string &needle, SearchMode mode) const {
+	for (uint32_t d = detailStart[id]; d < detailStart[id + 1]; d++) {
+		if (details.matches(d, needle, mode)) return true;
+	}
+	return false;
+}
+
+template<class T> static void buildTable(SearchTable &table, const SharedVector<T> &items) {
+	std::vector<const std::string *> names, details;
+	names.reserve(items.size());
+	table.detailOwner.clear();
+	table.detailStart.clear();
+	table.detailStart.reserve(items.size() + 1);
+	for (uint32_t id = 0; id < items.size(); id++) {
+		names.push_back(&items[id]->name);
+		table.detailStart.push_back(details.size());
+		for (auto detail : items[id]->searchableStringDetails()) {
+			details.push_back(detail);
+			table.detailOwner.push_back(id);
+		}
+	}
+	table.detailStart.push_back(details.size());
+
+	table.names.build(names);
+	table.details.build(details);
+}
+
+Searcher::~Searcher() {
+	cancelAll();
+}
+
+// Wait for the background searches, the tables they use are about to change
+void Searcher::cancelAll() {
+	m_cancelAll = true;
+	std::unique_lock<std::mutex> lock(m_tasksMutex);
+	m_tasksDone.wait(lock, [this] { return m_tasks == 0; });
+	m_cancelAll = false;
+}
+
 void Searcher::setNets(SharedVector<Net> nets) {
+	cancelAll();
 	this->m_nets = nets;
+	m_cache.clear();
+	m_generation++;
+	buildTable(m_netTable, m_nets);
 }
 
 void Searcher::setParts(SharedVector<Component> components) {
+	cancelAll();
 	this->m_parts = components;
+	m_cache.clear();
+	m_generation++;
+	buildTable(m_partTable, m_parts);
 }
 
 bool Searcher::isMode(SearchMode sm) {
@@ -17,48 +183,121 @@ void Searcher::setMode(SearchMode sm) {
 	m_searchMode = sm;
 }
 
-bool Searcher::strstrModeSearch(const std::string &strhaystack, const std::string &strneedle) {
-	size_t nl = strneedle.size();
-	size_t hl = strhaystack.size();
-	const char *needle = strneedle.c_str();
-	const char *haystack = strhaystack.c_str();
-	const char *sr;
+/*
+ * Ascending ids of the items of table matching query. With base, the matches of a shorter query this one
+ * extends, only those are checked. publish gets the matches found so far, cancelled is polled between chunks.
+ * Returns false when cancelled, ids are incomplete then.
+ */
+static bool computeSearch(const SearchTable &table,
+                          const std::string &query,
+                          SearchMode mode,
+                          bool details,
+                          const std::vector<uint32_t> *base,
+                          std::vector<uint32_t> &ids,
+                          const std::function<bool()> &cancelled,
+                          const std::function<void(const std::vector<uint32_t> &)> &publish) {
+	static const size_t kChunk = 4096;
 
-	sr = strcasestr(haystack, needle);
-	if (sr) {
-		if ((m_searchMode == SearchMode::Sub) || ((m_searchMode == SearchMode::Prefix) && (sr == haystack)) ||
-		    ((m_searchMode == SearchMode::Whole) && (sr == haystack) && (nl == hl))) {
-			return true;
+	ids.clear();
+	if (base) {
+		// Items matching the extended query are a subset of the ones matching the previous query
+		for (size_t i = 0; i < base->size(); i++) {
+			uint32_t id = (*base)[i];
+			if (table.names.matches(id, query, mode) || (details && table.detailsMatch(id, query, mode))) ids.push_back(id);
+			if ((i + 1) % kChunk == 0) {
+				if (cancelled && cancelled()) return false;
+				if (publish) publish(ids);
+			}
 		}
+		if (publish) publish(ids);
+		return true;
 	}
 
-	return false;
+	table.names.find(query, mode, ids);
+	if (publish) publish(ids);
+	if (!details) return true;
+	if (cancelled && cancelled()) return false;
+
+	std::vector<uint32_t> detail_ids;
+	table.details.find(query, mode, detail_ids);
+	for (auto d : detail_ids) ids.push_back(table.detailOwner[d]);
+	std::sort(ids.begin(), ids.end());
+	ids.erase(std::unique(ids.begin(), ids.end()), ids.end());
+	if (publish) publish(ids);
+	return true;
+}
+
+// Entry for query, or the one of the longest earlier query it extends (one more character typed)
+const Searcher::CachedSearch *
+Searcher::findCached(const std::string &query, const SearchTable &table, SearchMode mode, bool details, bool &exact) {
+	m_cacheClock++;
+	exact = false;
+
+	CachedSearch *base = nullptr;
+	for (auto &c : m_cache) {
+		if (c.table != &table || c.mode != mode || c.details != details) continue;
+		if (c.query == query) {
+			c.lastUse = m_cacheClock;
+			exact     = true;
+			return &c;
+		}
+		if (mode != SearchMode::Whole && c.query.size() < query.size() && !query.compare(0, c.query.size(), c.query) &&
+		    (!base || c.query.size() > base->query.size()))
+			base = &c;
+	}
+	return base;
+}
+
+const std::vector<uint32_t> &
+Searcher::storeCached(const std::string &query, const SearchTable &table, SearchMode mode, bool details, std::vector<uint32_t> &ids) {
+	// Replace the same query, or reuse the least recently used entry once the cache is full
+	CachedSearch *entry = nullptr;
+	for (auto &c : m_cache) {
+		if (c.table == &table && c.mode == mode && c.details == details && c.query == query) entry = &c;
+	}
+	if (!entry && m_cache.size() < kCacheSize) {
+		m_cache.emplace_back();
+		entry = &m_cache.back();
+	} else if (!entry) {
+		entry = &*std::min_element(
+		    m_cache.begin(), m_cache.end(), [](const CachedSearch &a, const CachedSearch &b) { return a.lastUse < b.lastUse; });
+	}
+	entry->table   = &table;
+	entry->query   = query;
+	entry->mode    = mode;
+	entry->details = details;
+	entry->ids.swap(ids);
+	entry->lastUse = m_cacheClock;
+	return entry->ids;
+}
+
+const std::vector<uint32_t> &
+Searcher::cachedSearch(const std::string &query, const SearchTable &table, SearchMode mode, bool details) {
+	bool exact;
+	const CachedSearch *base = findCached(query, table, mode, details, exact);
+	if (exact) return base->ids;
+
+	std::vector<uint32_t> ids;
+	computeSearch(table, query, mode, details, base ? &base->ids : nullptr, ids, nullptr, nullptr);
+	return storeCached(query, table, mode, details, ids);
 }
 
-template<class T> std::vector<T> Searcher::searchFor(const std::string& search, std::vector<T> v,  int limit) {
+template<class T>
+std::vector<T> Searcher::searchFor(const std::string &search, const std::vector<T> &v, const SearchTable &table, int limit) {
 	std::vector<T> results;
 
 	if (search.empty()) return results;
 
-	for (auto &p : v) {
-		bool match = strstrModeSearch(p->name, search);
-		if (m_search_details && !match) {
-			const auto details = p->searchableStringDetails();
-			for (auto s = details.begin(); s != details.end() && !match; ++s) {
-				match |= strstrModeSearch(**s, search);
-			}
-		}
-		if (match) {
-			results.push_back(p);
-			limit--;
-		}
-		if (limit == 0) return results;
+	for (auto id : cachedSearch(SearchIndex::fold(search), table, m_searchMode, m_search_details)) {
+		results.push_back(v[id]);
+		limit--;
+		if (limit == 0) break;
 	}
 	return results;
 }
 
 SharedVector<Component> Searcher::parts(const std::string& search, int limit) {
-	return searchFor(search, m_parts, limit);
+	return searchFor(search, m_parts, m_partTable, limit);
 }
 
 SharedVector<Component> Searcher::parts(const std::string& search) {
@@ -66,9 +305,116 @@ SharedVector<Component> Searcher::parts(const std::string& search) {
 }
 
 SharedVector<Net> Searcher::nets(const std::string& search, int limit) {
-	return searchFor(search, m_nets, limit);
+	return searchFor(search, m_nets, m_netTable, limit);
 }
 
 SharedVector<Net> Searcher::nets(const std::string& search) {
 	return nets(search, -1);
 }
+
+const std::vector<uint32_t> &Searcher::netIds(const std::string &search) {
+	return cachedSearch(SearchIndex::fold(search), m_netTable, SearchMode::Sub, false);
+}
+
+const std::vector<uint32_t> &Searcher::partIds(const std::string &search) {
+	return cachedSearch(SearchIndex::fold(search), m_partTable, SearchMode::Sub, false);
+}
+
+std::shared_ptr<SearchQuery> Searcher::searchAsync(const std::string &search, bool parts, bool nets) {
+	auto query          = std::make_shared<SearchQuery>();
+	query->m_search     = search;
+	query->m_query      = SearchIndex::fold(search);
+	query->m_mode       = m_searchMode;
+	query->m_details    = m_search_details;
+	query->m_parts      = parts;
+	query->m_nets       = nets;
+	query->m_generation = m_generation;
+	if (search.empty()) return query;
+
+	if (parts) startSearch(query, m_partTable, query->m_partIds);
+	if (nets) startSearch(query, m_netTable, query->m_netIds);
+	return query;
+}
+
+void Searcher::startSearch(const std::shared_ptr<SearchQuery> &query, const SearchTable &table, std::vector<uint32_t> &ids) {
+	bool exact;
+	const CachedSearch *cached = findCached(query->m_query, table, query->m_mode, query->m_details, exact);
+	if (exact) {
+		std::lock_guard<std::mutex> lock(query->m_mutex);
+		ids = cached->ids;
+		return;
+	}
+
+	// Copy of the base matches, the cache may change while the search runs
+	std::shared_ptr<std::vector<uint32_t>> base;
+	if (cached) base = std::make_shared<std::vector<uint32_t>>(cached->ids);
+
+	query->m_pending++;
+	{
+		std::lock_guard<std::mutex> lock(m_tasksMutex);
+		m_tasks++;
+	}
+	const SearchTable *t = &table;
+	m_pool.submit([this, query, t, &ids, base]() {
+		std::vector<uint32_t> found;
+		computeSearch(*t,
+		              query->m_query,
+		              query->m_mode,
+		              query->m_details,
+		              base.get(),
+		              found,
+		              [this, &query]() { return query->m_cancelled || m_cancelAll; },
+		              [this, &query, &ids](const std::vector<uint32_t> &partial) {
+			              {
+				              std::lock_guard<std::mutex> lock(query->m_mutex);
+				              ids = partial;
+			              }
+			              if (m_notify) m_notify();
+		              });
+		query->m_pending--;
+		if (m_notify) m_notify();
+
+		std::lock_guard<std::mutex> lock(m_tasksMutex);
+		m_tasks--;
+		m_tasksDone.notify_all();
+	});
+}
+
+void Searcher::setNotify(std::function<void()> notify) {
+	cancelAll(); // no search may be calling the old one
+	m_notify = notify;
+}
+
+bool Searcher::isCurrent(const SearchQuery &query, const std::string &search, bool parts, bool nets) const {
+	return query.m_generation == m_generation && query.m_search == search && query.m_mode == m_searchMode &&
+	       query.m_details == m_search_details && query.m_parts == parts && query.m_nets == nets;
+}
+
+std::pair<SharedVector<Component>, SharedVector<Net>> Searcher::results(SearchQuery &query, int limit) {
+	SharedVector<Component> parts;
+	SharedVector<Net> nets;
+	if (query.m_generation != m_generation) return {parts, nets}; // Board changed since
+
+	bool done = query.done();
+	std::lock_guard<std::mutex> lock(query.m_mutex);
+
+	// Complete results also serve the synchronous searches (highlighting, Search button)
+	if (done && !query.m_cached && !query.m_cancelled && !query.m_search.empty()) {
+		query.m_cached = true;
+		std::vector<uint32_t> ids;
+		if (query.m_parts) storeCached(query.m_query, m_partTable, query.m_mode, query.m_details, ids = query.m_partIds);
+		if (query.m_nets) storeCached(query.m_query, m_netTable, query.m_mode, query.m_details, ids = query.m_netIds);
+	}
+
+	int left = limit;
+	for (auto id : query.m_partIds) {
+		if (left-- == 0) break;
+		parts.push_back(m_parts[id]);
+	}
+	left = limit;
+	for (auto id : query.m_netIds) {
+		if (left-- == 0) break;
+		nets.push_back(m_nets[id]);
+	}
+	return {parts, nets};
+}
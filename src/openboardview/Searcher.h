@@ -1,4 +1,11 @@
 #include "BRDBoard.h"
+#include "WorkerPool.h"
+
+#include <atomic>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <mutex>
 
 enum class SearchMode {
 	Sub,
@@ -6,16 +13,116 @@ enum class SearchMode {
 	Whole,
 };
 
+// Case-folded names of one kind of item (nets, parts), built once per board.
+// Sub mode looks up the 1 to 3 character grams of the needle, Prefix/Whole binary search the sorted names.
+class SearchIndex {
+	std::string m_blob;                // folded names, '\0' terminated, item i starts at m_offsets[i]
+	std::vector<uint32_t> m_offsets;   // size is item count + 1
+	std::vector<uint32_t> m_sorted;    // item ids sorted by folded name
+	std::vector<uint32_t> m_grams;     // sorted distinct grams, see gram()
+	std::vector<uint32_t> m_gramStart; // postings of m_grams[i] are m_postings[m_gramStart[i]..m_gramStart[i + 1])
+	std::vector<uint32_t> m_postings;  // ascending item ids
+
+	static uint32_t gram(const char *s, size_t n);
+	const char *name(uint32_t id) const {
+		return &m_blob[m_offsets[id]];
+	}
+	size_t nameSize(uint32_t id) const {
+		return m_offsets[id + 1] - m_offsets[id] - 1;
+	}
+	bool postings(uint32_t g, const uint32_t *&begin, const uint32_t *&end) const;
+public:
+	static std::string fold(const std::string &s);
+
+	void build(const std::vector<const std::string *> &names);
+	size_t size() const {
+		return m_sorted.size();
+	}
+
+	// Ascending ids of items whose name matches needle (already folded)
+	void find(const std::string &needle, SearchMode mode, std::vector<uint32_t> &ids) const;
+	// Whether the name of item id matches needle (already folded)
+	bool matches(uint32_t id, const std::string &needle, SearchMode mode) const;
+};
+
+// Names of one kind of item and their details (pin names/numbers of nets, mfgcode of parts) flattened into a second index
+struct SearchTable {
+	SearchIndex names;
+	SearchIndex details;
+	std::vector<uint32_t> detailOwner; // item id of each detail string
+	std::vector<uint32_t> detailStart; // details of item i are detailStart[i]..detailStart[i + 1]
+
+	bool detailsMatch(uint32_t id, const std::string &needle, SearchMode mode) const;
+};
+
+// Parts and nets matching one query, searched on the Searcher worker pool. See Searcher::searchAsync().
+class SearchQuery {
+	friend class Searcher;
+
+	std::string m_search;      // as typed
+	std::string m_query;       // folded
+	SearchMode m_mode;
+	bool m_details;
+	bool m_parts, m_nets;      // kinds of items searched
+	unsigned int m_generation; // board the ids refer to
+	bool m_cached = false;     // complete results were added to the Searcher cache
+
+	std::atomic<bool> m_cancelled{false};
+	std::atomic<int> m_pending{0}; // searches still running
+
+	std::mutex m_mutex; // guards the ids, they grow while the searches run
+	std::vector<uint32_t> m_partIds, m_netIds;
+
+public:
+	bool done() const {
+		return m_pending == 0;
+	}
+	void cancel() {
+		m_cancelled = true;
+	}
+};
+
 class Searcher {
 	SearchMode m_searchMode = SearchMode::Sub;
 	bool m_search_details   = false;
 
 	SharedVector<Net> m_nets;
 	SharedVector<Component> m_parts;
+	SearchTable m_netTable;
+	SearchTable m_partTable;
+	unsigned int m_generation = 0; // bumped when the board changes
+
+	// Results of the last few queries, the search popup runs the same ones every frame while open
+	struct CachedSearch {
+		const SearchTable *table; // nets or parts
+		std::string query;        // folded
+		SearchMode mode;
+		bool details;
+		std::vector<uint32_t> ids; // all matches, ascending
+		unsigned int lastUse;
+	};
+	static const size_t kCacheSize = 8;
+	std::vector<CachedSearch> m_cache;
+	unsigned int m_cacheClock = 0;
 
-	template<class T> std::vector<T> searchFor(const std::string& search, std::vector<T> v,  int limit);
-	bool strstrModeSearch(const std::string &strhaystack, const std::string &strneedle);
+	// Searches running on the pool, the tables must not change until they are done
+	std::mutex m_tasksMutex;
+	std::condition_variable m_tasksDone;
+	int m_tasks = 0;
+	std::atomic<bool> m_cancelAll{false};
+	std::function<void()> m_notify; // called on the pool threads when a query has new matches
+
+	const CachedSearch *findCached(const std::string &query, const SearchTable &table, SearchMode mode, bool details, bool &exact);
+	const std::vector<uint32_t> &storeCached(const std::string &query, const SearchTable &table, SearchMode mode, bool details, std::vector<uint32_t> &ids);
+	const std::vector<uint32_t> &cachedSearch(const std::string &query, const SearchTable &table, SearchMode mode, bool details);
+	template<class T> std::vector<T> searchFor(const std::string& search, const std::vector<T> &v, const SearchTable &table, int limit);
+	void startSearch(const std::shared_ptr<SearchQuery> &query, const SearchTable &table, std::vector<uint32_t> &ids);
+	void cancelAll();
+
+	WorkerPool m_pool{WorkerPool::threadsFor(2)}; // last, joined before the tables are destroyed
 public:
+	~Searcher();
+
 	void setNets(SharedVector<Net> nets);
 	void setParts(SharedVector<Component> components);
 
@@ -26,6 +133,24 @@ public:
 	SharedVector<Net> nets(const std::string& search, int limit);
 	SharedVector<Net> nets(const std::string& search);
 
+	// Indices in the nets/parts vectors of the names containing search, whatever the search mode
+	const std::vector<uint32_t> &netIds(const std::string &search);
+	const std::vector<uint32_t> &partIds(const std::string &search);
+	// Bumped when the nets or parts change
+	unsigned int generation() const {
+		return m_generation;
+	}
+
+	// notify is called from the pool threads whenever a background search found more matches or finished
+	void setNotify(std::function<void()> notify);
+
+	// Start searching parts and/or nets in the background, with the current mode and details setting
+	std::shared_ptr<SearchQuery> searchAsync(const std::string &search, bool parts, bool nets);
+	// Whether query is the search that searchAsync() would start now
+	bool isCurrent(const SearchQuery &query, const std::string &search, bool parts, bool nets) const;
+	// Matches found so far, at most limit of each kind (-1: all)
+	std::pair<SharedVector<Component>, SharedVector<Net>> results(SearchQuery &query, int limit);
+
 	bool &configSearchDetails() {
 		return m_search_details;
 	}
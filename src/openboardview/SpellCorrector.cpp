@@ -1,59 +1,147 @@
 #include "SpellCorrector.h"
 
+#include <cctype>
+#include <numeric>
+
+static std::string lowercase(const std::string &s) {
+	std::string lower = s;
+	for (auto &c : lower) c = tolower(static_cast<unsigned char>(c));
+	return lower;
+}
+
 void SpellCorrector::setDictionary(const std::vector<std::string>& dictionary) {
 	this->dictionary = dictionary;
-}
+	cache.clear();
 
-/**
- * From https://en.wikibooks.org/wiki/Algorithm_Implementation/Strings/Levenshtein_distance#C.2B.2B
- * Added a limit parameter to limit the machting to n characters of the second string.
- */
-unsigned int SpellCorrector::levenshtein_distance(const std::string& s1, const std::string& s2, size_t limit) {
-	const std::size_t len1 = s1.size(), len2 = s2.size();
-	limit = std::min(limit, len2);
-	std::vector<unsigned int> col(limit+1), prevCol(limit+1);
-
-	for (unsigned int i = 0; i < prevCol.size(); i++)
-		prevCol[i] = i;
-	for (unsigned int i = 0; i < len1; i++) {
-		col[0] = i+1;
-		for (unsigned int j = 0; j < limit; j++)
-			col[j+1] = std::min({ prevCol[1 + j] + 1, col[j] + 1, prevCol[j] + (s1[i]==s2[j] ? 0 : 1) });
-		col.swap(prevCol);
-	}
-	return prevCol[limit];
+	std::vector<std::string> lowered;
+	lowered.reserve(dictionary.size());
+	for (auto &s : dictionary) lowered.push_back(lowercase(s));
+
+	order.resize(dictionary.size());
+	std::iota(order.begin(), order.end(), 0);
+	std::stable_sort(order.begin(), order.end(), [&lowered](uint32_t a, uint32_t b) { return lowered[a] < lowered[b]; });
+
+	// Breadth first so the children of a node are created next to each other
+	std::vector<uint32_t> depths;
+	nodes.clear();
+	nodes.push_back({0, 0, 0, 0, static_cast<uint32_t>(order.size()), 0});
+	depths.push_back(0);
+	for (size_t i = 0; i < nodes.size(); i++) {
+		uint32_t depth = depths[i];
+		uint32_t end   = nodes[i].wordEnd;
+		uint32_t w     = nodes[i].wordBegin;
+
+		// Words equal to the prefix sort first
+		while (w < end && lowered[order[w]].size() == depth) w++;
+		nodes[i].wordsEnding = w - nodes[i].wordBegin;
+
+		nodes[i].childBegin = nodes.size();
+		while (w < end) {
+			char c     = lowered[order[w]][depth];
+			uint32_t e = w;
+			while (e < end && lowered[order[e]][depth] == c) e++;
+			nodes.push_back({c, 0, 0, w, e, 0});
+			depths.push_back(depth + 1);
+			w = e;
+		}
+		nodes[i].childEnd = nodes.size();
+	}
 }
 
 /**
- * Compute the levenshtein distance with a limit to s1 length + 1 character.
- * Returns 0 (meaning not matched) when the distance is above the threshold.
+ * Levenshtein distance between word and each trie prefix, one DP row per depth
+ * (see https://en.wikibooks.org/wiki/Algorithm_Implementation/Strings/Levenshtein_distance#C.2B.2B).
+ * Words are only compared up to word length + 1 characters, so the walk stops at that depth
+ * or as soon as every cell of the row reached the threshold.
  */
-unsigned int SpellCorrector::fuzzy_match(const std::string& s1, const std::string& s2) {
-	unsigned int score = levenshtein_distance(s1, s2, s1.size() + 1);
-	if (score > this->threshold) return 0;
-	return threshold - score;
+void SpellCorrector::walk(const std::string &word, uint32_t node, size_t depth) {
+	const size_t len         = word.size();
+	const unsigned int *row  = &rows[depth * (len + 1)];
+	const Node &n            = nodes[node];
+	unsigned int distance    = row[len];
+
+	if (depth == len + 1) {
+		if (distance < threshold) matches[distance].push_back({n.wordBegin, n.wordEnd});
+		return;
+	}
+	if (n.wordsEnding && distance < threshold) matches[distance].push_back({n.wordBegin, n.wordBegin + n.wordsEnding});
+
+	if (*std::min_element(row, row + len + 1) >= threshold) return; // Distance never decreases below this node
+
+	unsigned int *next = &rows[(depth + 1) * (len + 1)];
+	for (uint32_t child = n.childBegin; child < n.childEnd; child++) {
+		char c  = nodes[child].c;
+		next[0] = depth + 1;
+		for (size_t j = 1; j <= len; j++)
+			next[j] = std::min({row[j] + 1, next[j - 1] + 1, row[j - 1] + (word[j - 1] == c ? 0 : 1)});
+		walk(word, child, depth + 1);
+	}
 }
 
-std::vector<std::string> SpellCorrector::suggest(const std::string& word) {
-	std::vector<std::string> suggestions; // What will actually be returned, a vector of matched words with levenshtein below the threshold
-	std::vector<std::pair<std::string, unsigned int>> scores; // Vector of pairs of matched words and their associated score
-	std::string wordLower = word;
-	std::transform(wordLower.begin(), wordLower.end(), wordLower.begin(), ::tolower); // Lowercase the word to search for
+// Same walk with a bit-parallel column for words up to 64 characters.
+// A cell is at least the difference of the prefix lengths, so only the cells within threshold of the diagonal
+// can be under the threshold. Their minimum gives the same cut as the DP row minimum for a few popcounts.
+void SpellCorrector::walkMyers(const MyersPattern &word, MyersState state, uint32_t node, size_t depth) {
+	const size_t len      = word.length;
+	const Node &n         = nodes[node];
+	unsigned int distance = state.score;
+
+	if (depth == len + 1) {
+		if (distance < threshold) matches[distance].push_back({n.wordBegin, n.wordEnd});
+		return;
+	}
+	if (n.wordsEnding && distance < threshold) matches[distance].push_back({n.wordBegin, n.wordBegin + n.wordsEnding});
 
-	for (auto &s : dictionary) {
-		std::string sLower = s;
-		std::transform(sLower.begin(), sLower.end(), sLower.begin(), ::tolower); // Lowercase the word from the dictionary
+	size_t first       = depth >= threshold ? depth - threshold + 1 : 0;
+	size_t last        = std::min(len, depth + threshold - 1);
+	unsigned int cell  = state.prefixScore(first, depth);
+	unsigned int least = cell;
+	for (size_t i = first; i < last; i++) {
+		if ((state.pv >> i) & 1) cell++;
+		if ((state.mv >> i) & 1) cell--;
+		least = std::min(least, cell);
+	}
+	if (least >= threshold) return; // Distance never decreases below this node
 
-		unsigned int score = fuzzy_match(wordLower, sLower);
-		if (score) scores.push_back({s, score});
+	for (uint32_t child = n.childBegin; child < n.childEnd; child++) {
+		MyersState next = state;
+		next.step(word, nodes[child].c);
+		walkMyers(word, next, child, depth + 1);
 	}
+}
+
+const std::vector<std::string> &SpellCorrector::suggest(const std::string& word, size_t limit) {
+	std::string wordLower = lowercase(word);
 
-	// Sort by score, descending
-	std::sort(scores.begin(), scores.end(), [] (const std::pair<std::string, unsigned int>& v1, const std::pair<std::string, unsigned int>& v2) {
-		return v1.second > v2.second;
-	});
+	// The search popup asks for the same suggestions every frame
+	auto cached = cache.find(wordLower);
+	if (cached != cache.end() && cached->second.limit == limit) return cached->second.suggestions;
+	if (cache.size() >= 64) cache.clear();
 
-	for (auto &p : scores) suggestions.push_back(p.first);
+	CachedSuggestion &entry = cache[wordLower];
+	entry.limit             = limit;
+	entry.suggestions.clear();
+	if (nodes.empty()) return entry.suggestions;
 
-	return suggestions;
+	for (auto &m : matches) m.clear();
+	const size_t len = wordLower.size();
+	if (bitParallel && len > 0 && len <= MyersPattern::kMaxLength) {
+		MyersPattern pattern(wordLower);
+		walkMyers(pattern, MyersState(pattern), 0, 0);
+	} else {
+		rows.resize((len + 2) * (len + 1));
+		std::iota(rows.begin(), rows.begin() + len + 1, 0);
+		walk(wordLower, 0, 0);
+	}
+
+	// Closest first, each list is already in alphabetical order
+	for (auto &m : matches) {
+		for (auto &range : m) {
+			for (uint32_t i = range.begin; i < range.end; i++) {
+				if (limit && entry.suggestions.size() == limit) return entry.suggestions;
+				entry.suggestions.push_back(dictionary[order[i]]);
+			}
+		}
+	}
+	return entry.suggestions;
 }
@@ -1,16 +1,51 @@
 #include <string>
 #include <vector>
 #include <algorithm>
+#include <cstdint>
+#include <unordered_map>
+
+#include "Levenshtein.h"
 
 class SpellCorrector {
-	unsigned int threshold = 3;
+	static const unsigned int threshold = 3; // words at this distance or more are not suggested
 	std::vector<std::string> dictionary;
 
-	unsigned int levenshtein_distance(const std::string& s1, const std::string& s2, size_t limit);
-	unsigned int fuzzy_match(const std::string& s1, const std::string& s2);
+	/*
+	 * Trie of the lowercased dictionary. A word only matches against its first query length + 1
+	 * characters, so every word below a node at that depth shares the distance computed along the path.
+	 * Words are sorted, so the words below a node are a contiguous range of order.
+	 */
+	struct Node {
+		char c;
+		uint32_t childBegin, childEnd; // children are contiguous in nodes
+		uint32_t wordBegin, wordEnd;   // words below this node in order
+		uint32_t wordsEnding;          // the first wordsEnding words of the range end at this node
+	};
+	std::vector<Node> nodes;
+	std::vector<uint32_t> order; // dictionary indices sorted by lowercased word
+
+	// Ranges of order matched by the current query, one list per distance
+	struct Match {
+		uint32_t begin, end;
+	};
+	std::vector<Match> matches[threshold];
+	std::vector<unsigned int> rows; // DP row of each depth of the walk
+
+	struct CachedSuggestion {
+		size_t limit;
+		std::vector<std::string> suggestions;
+	};
+	std::unordered_map<std::string, CachedSuggestion> cache;
+
+	void walk(const std::string &word, uint32_t node, size_t depth);
+	void walkMyers(const MyersPattern &word, MyersState state, uint32_t node, size_t depth);
 
 public:
+	// Bit-parallel walk for words up to 64 characters, the DP walk otherwise. Off only to compare them.
+	bool bitParallel = true;
+
 	void setDictionary(const std::vector<std::string>& dictionnary);
 
-	std::vector<std::string> suggest(const std::string& word);
+	// Dictionary words within the threshold, closest first then alphabetically, at most limit of them (0: all)
+	const std::vector<std::string> &suggest(const std::string& word, size_t limit = 0);
 };
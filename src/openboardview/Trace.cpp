@@ -0,0 +1,127 @@
+#include "Trace.h"
+
+#include <cstdio>
+#include <mutex>
+#include <vector>
+
+namespace Trace {
+
+std::atomic<bool> recording{false};
+
+namespace {
+struct Event {
+	const char *name;
+	std::string detail;
+	int tid;
+	Clock::time_point begin, end;
+};
+
+std::mutex mutex; // guards everything below
+std::string file;
+std::vector<Event> events;
+Clock::time_point epoch;
+int frameLimit = 0;
+int frameCount = 0;
+bool counting  = false; // frames only count once a board load started
+
+std::atomic<int> nextTid{1};
+
+// Small thread numbers, in order of the first event of each thread
+int threadId() {
+	thread_local int tid = nextTid++;
+	return tid;
+}
+
+void writeString(FILE *f, const char *s) {
+	fputc('"', f);
+	for (; *s; s++) {
+		unsigned char c = *s;
+		if (c == '"' || c == '\\')
+			fprintf(f, "\\%c", c);
+		else if (c < 0x20)
+			fprintf(f, "\\u%04x", c);
+		else
+			fputc(c, f);
+	}
+	fputc('"', f);
+}
+} // namespace
+
+bool start(const std::string &filename, int frames) {
+	threadId(); // the caller is the main thread, tid 1
+	std::lock_guard<std::mutex> lock(mutex);
+	FILE *f = fopen(filename.c_str(), "wb"); // fail now rather than after recording
+	if (!f) {
+		fprintf(stderr, "Cannot write trace file %s\n", filename.c_str());
+		return false;
+	}
+	fclose(f);
+
+	file       = filename;
+	frameLimit = frames;
+	frameCount = 0;
+	counting   = false;
+	epoch      = Clock::now();
+	events.clear();
+	recording = true;
+	return true;
+}
+
+void stop() {
+	std::lock_guard<std::mutex> lock(mutex);
+	if (!recording) return;
+	recording = false;
+
+	FILE *f = fopen(file.c_str(), "wb");
+	if (!f) {
+		fprintf(stderr, "Cannot write trace file %s\n", file.c_str());
+		return;
+	}
+	fputs("{\"displayTimeUnit\":\"ms\",\"traceEvents\":[\n", f);
+	fputs("{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":1,\"tid\":1,\"args\":{\"name\":\"main\"}}", f);
+	for (auto &e : events) {
+		using us = std::chrono::duration<double, std::micro>;
+		fputs(",\n{\"name\":", f);
+		writeString(f, e.name);
+		fprintf(f,
+		        ",\"ph\":\"X\",\"pid\":1,\"tid\":%d,\"ts\":%.3f,\"dur\":%.3f",
+		        e.tid,
+		        us(e.begin - epoch).count(),
+		        us(e.end - e.begin).count());
+		if (!e.detail.empty()) {
+			fputs(",\"args\":{\"detail\":", f);
+			writeString(f, e.detail.c_str());
+			fputc('}', f);
+		}
+		fputc('}', f);
+	}
+	fputs("\n]}\n", f);
+	fclose(f);
+	fprintf(stderr, "Trace of %zu events written to %s\n", events.size(), file.c_str());
+	events.clear();
+	events.shrink_to_fit();
+}
+
+void frameStart() {
+	if (!enabled()) return;
+	{
+		std::lock_guard<std::mutex> lock(mutex);
+		if (!counting || frameCount++ < frameLimit) return;
+	}
+	stop();
+}
+
+void restartFrames() {
+	std::lock_guard<std::mutex> lock(mutex);
+	frameCount = 0;
+	counting   = true;
+}
+
+void complete(const char *name, Clock::time_point begin, Clock::time_point end, const std::string &detail) {
+	int tid = threadId();
+	std::lock_guard<std::mutex> lock(mutex);
+	if (!recording) return; // stopped since the scope began
+	events.push_back({name, detail, tid, begin, end});
+}
+
+} // namespace Trace
@@ -0,0 +1,62 @@
+#ifndef _TRACE_H_
+#define _TRACE_H_
+
+#include <atomic>
+#include <chrono>
+#include <string>
+
+/*
+ * Chrome trace event recorder, the output opens in chrome://tracing and
+ * Perfetto. Recording is started by the -t command line option, events are
+ * kept in memory until stop() writes the file. While not recording a
+ * TraceScope costs one relaxed atomic load.
+ */
+namespace Trace {
+using Clock = std::chrono::steady_clock;
+
+extern std::atomic<bool> recording;
+
+inline bool enabled() {
+	return recording.load(std::memory_order_relaxed);
+}
+
+// Record to filename until frames frames have been rendered since the last board load.
+// Frames before the first load do not count, menus and the file dialog can take any time.
+bool start(const std::string &filename, int frames);
+// Write the events recorded so far to the file and stop recording
+void stop();
+// Called by the main loop before each frame, stops once enough frames are in
+void frameStart();
+// Count the frames from now on, a board is being loaded
+void restartFrames();
+
+// A complete event, name must outlive the recording (string literal)
+void complete(const char *name, Clock::time_point begin, Clock::time_point end, const std::string &detail = {});
+} // namespace Trace
+
+// Records the scope as an event of the calling thread
+class TraceScope {
+	const char *m_name;
+	bool m_active;
+	std::string m_detail;
+	Trace::Clock::time_point m_begin;
+
+public:
+	explicit TraceScope(const char *name) : m_name(name), m_active(Trace::enabled()) {
+		if (m_active) m_begin = Trace::Clock::now();
+	}
+	// detail shows in the event arguments, e.g. the file name
+	TraceScope(const char *name, const std::string &detail) : m_name(name), m_active(Trace::enabled()) {
+		if (!m_active) return;
+		m_detail = detail;
+		m_begin  = Trace::Clock::now();
+	}
+	~TraceScope() {
+		if (m_active) Trace::complete(m_name, m_begin, Trace::Clock::now(), m_detail);
+	}
+
+	TraceScope(const TraceScope &) = delete;
+	TraceScope &operator=(const TraceScope &) = delete;
+};
+
+#endif
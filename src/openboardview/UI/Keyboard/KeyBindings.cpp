@@ -141,6 +141,7 @@ void KeyBindings::readFromConfig(Confparse &obvconfig) {
 }
 
 void KeyBindings::writeToConfig(Confparse &obvconfig) {
+	obvconfig.Begin();
 	for (auto &keybinding : keybindings) {
 		std::string line;
 		for (auto &kbs : keybinding.second) {
@@ -170,6 +171,7 @@ void KeyBindings::writeToConfig(Confparse &obvconfig) {
 		}
 		obvconfig.WriteStr(("KeyBinding" + keybinding.first).c_str(), line.c_str());
 	}
+	obvconfig.Commit();
 }
 
 std::string KeyBindings::getKeyNames(const std::string &bindname) const {
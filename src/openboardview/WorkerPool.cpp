@@ -0,0 +1,43 @@
+#include "WorkerPool.h"
+
+#include <algorithm>
+
+WorkerPool::WorkerPool(unsigned int count) {
+	for (unsigned int i = 0; i < count; i++) threads.emplace_back(&WorkerPool::run, this);
+}
+
+WorkerPool::~WorkerPool() {
+	{
+		std::lock_guard<std::mutex> lock(mutex);
+		stopping = true;
+	}
+	wake.notify_all();
+	for (auto &t : threads) t.join();
+}
+
+void WorkerPool::submit(std::function<void()> job) {
+	{
+		std::lock_guard<std::mutex> lock(mutex);
+		jobs.push_back(std::move(job));
+	}
+	wake.notify_one();
+}
+
+void WorkerPool::run() {
+	for (;;) {
+		std::function<void()> job;
+		{
+			std::unique_lock<std::mutex> lock(mutex);
+			wake.wait(lock, [this] { return stopping || !jobs.empty(); });
+			if (jobs.empty()) return; // stopping and nothing left
+			job = std::move(jobs.front());
+			jobs.pop_front();
+		}
+		job();
+	}
+}
+
+unsigned int WorkerPool::threadsFor(unsigned int count) {
+	unsigned int hardware = std::thread::hardware_concurrency(); // 0 when unknown
+	return std::max(1u, hardware ? std::min(count, hardware) : count);
+}
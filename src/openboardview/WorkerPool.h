@@ -0,0 +1,35 @@
+#ifndef _WORKERPOOL_H_
+#define _WORKERPOOL_H_
+
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+// Fixed set of threads running submitted jobs in order.
+// Jobs still queued when the pool is destroyed are run before the threads are joined.
+class WorkerPool {
+	std::vector<std::thread> threads;
+	std::deque<std::function<void()>> jobs;
+	std::mutex mutex;
+	std::condition_variable wake;
+	bool stopping = false;
+
+	void run();
+
+public:
+	explicit WorkerPool(unsigned int count);
+	~WorkerPool();
+
+	WorkerPool(const WorkerPool &) = delete;
+	WorkerPool &operator=(const WorkerPool &) = delete;
+
+	void submit(std::function<void()> job);
+
+	// Thread count for count jobs running at once, at most the hardware threads but at least one
+	static unsigned int threadsFor(unsigned int count);
+};
+
+#endif
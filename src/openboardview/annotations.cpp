@@ -1,3 +1,4 @@
+#include <algorithm>
 #include <cmath>
 #include <iostream>
 #include <climits>
@@ -8,6 +9,7 @@
 #include <vector>
 
 #include "annotations.h"
+#include "Trace.h"
 
 int Annotations::SetFilename(const std::string &f) {
 	filename = f;
@@ -56,45 +58,145 @@ int Annotations::Init(void) {
 	return 0;
 }
 
+template <class R> std::future<R> Annotations::Submit(std::function<R()> job) {
+	auto task = std::make_shared<std::packaged_task<R()>>(job);
+	io.submit([this, task] {
+		(*task)();
+		if (notify) notify();
+	});
+	return task->get_future();
+}
+
+/*
+ * The I/O thread opens a transaction for the first write it runs and commits
+ * once no other write is queued behind it, so a burst of edits costs one
+ * sync instead of one per note.
+ */
+template <class R> std::future<R> Annotations::SubmitWrite(std::function<R()> write) {
+	queuedWrites++;
+	return Submit<R>([this, write] {
+		if (!transaction) transaction = Run(beginStmt);
+		R result = write();
+		if (--queuedWrites == 0 && transaction) {
+			if (!Run(commitStmt)) {
+				sqlite3_exec(sqldb, "ROLLBACK;", NULL, 0, NULL);
+				batchFailed = true;
+			}
+			transaction = false;
+		}
+		return result;
+	});
+}
+
 int Annotations::Load(void) {
 	std::string sqlfn                        = filename;
 	auto pos                                 = sqlfn.rfind('.');
 	if (pos != std::string::npos) sqlfn[pos] = '_';
 	sqlfn += ".sqlite3";
 
-	sqldb = nullptr;
-	int r = sqlite3_open(sqlfn.c_str(), &sqldb);
-	if (r) {
-		fprintf(stderr, "Can't open database: %s\n", sqlite3_errmsg(sqldb));
-	} else {
+	annotations.clear();
+	indexed = false;
+	localEdits.clear();
+	loading = Submit<std::vector<Annotation>>([this, sqlfn] {
+		TraceScope trace("Annotations load", sqlfn);
+		sqldb = nullptr;
+		int r = sqlite3_open(sqlfn.c_str(), &sqldb);
+		if (r) {
+			fprintf(stderr, "Can't open database: %s\n", sqlite3_errmsg(sqldb));
+			return std::vector<Annotation>();
+		}
 		if (debug) fprintf(stderr, "Opened database successfully\n");
+
+		/*
+		 * Write ahead log: an edit appends to the log instead of rewriting
+		 * pages, and with synchronous=NORMAL only checkpoints wait for the disk
+		 */
+		sqlite3_exec(sqldb, "PRAGMA journal_mode=WAL; PRAGMA synchronous=NORMAL;", NULL, 0, NULL);
 		Init();
-		GenerateList();
+		Prepare();
+		return GenerateList();
+	});
+	return 0;
+}
+
+void Annotations::Reload(void) {
+	localEdits.clear();
+	loading = Submit<std::vector<Annotation>>([this] { return GenerateList(); });
+}
+
+int Annotations::Prepare(void) {
+	const char sql_insert[] = "INSERT into annotations ( visible, side, posx, posy, net, part, pin, note ) values ( 1, ?, ?, ?, ?, ?, ?, ? );";
+	const char sql_remove[] = "UPDATE annotations set visible = 0 where id=?;";
+	const char sql_update[] = "UPDATE annotations set note = ? where id=?;";
+
+	if (!sqldb) return 1;
+
+	int rc = sqlite3_prepare_v2(sqldb, sql_insert, -1, &insertStmt, NULL);
+	if (rc == SQLITE_OK) rc = sqlite3_prepare_v2(sqldb, sql_remove, -1, &removeStmt, NULL);
+	if (rc == SQLITE_OK) rc = sqlite3_prepare_v2(sqldb, sql_update, -1, &updateStmt, NULL);
+	if (rc == SQLITE_OK) rc = sqlite3_prepare_v2(sqldb, "BEGIN;", -1, &beginStmt, NULL);
+	if (rc == SQLITE_OK) rc = sqlite3_prepare_v2(sqldb, "COMMIT;", -1, &commitStmt, NULL);
+	if (rc != SQLITE_OK) {
+		if (debug) fprintf(stderr, "SQL error: %s\n", sqlite3_errmsg(sqldb));
+		return 1;
 	}
 	return 0;
 }
 
-int Annotations::Close(void) {
-	if (sqldb) {
-		sqlite3_close(sqldb);
-		sqldb = NULL;
+// Step a prepared statement to completion and make it ready for the next bindings
+bool Annotations::Run(sqlite3_stmt *stmt) {
+	if (!stmt) return false;
+
+	int rc = sqlite3_step(stmt);
+	if (rc != SQLITE_DONE) {
+		if (debug) fprintf(stderr, "SQL error: %s\n", sqlite3_errmsg(sqldb));
 	}
+	sqlite3_reset(stmt);
+	sqlite3_clear_bindings(stmt);
+	return rc == SQLITE_DONE;
+}
+
+// Row id of a note, added notes are known by a temporary id until their insert ran
+int Annotations::RowId(int id) {
+	if (id >= 0) return id;
+	auto it = insertedIds.find(id);
+	return it == insertedIds.end() ? -1 : it->second;
+}
+
+int Annotations::Close(void) {
+	Submit<bool>([this] {
+		if (transaction) Run(commitStmt);
+		transaction = false;
+		for (auto stmt : {&insertStmt, &removeStmt, &updateStmt, &beginStmt, &commitStmt}) {
+			sqlite3_finalize(*stmt);
+			*stmt = nullptr;
+		}
+		if (sqldb) {
+			sqlite3_close(sqldb);
+			sqldb = NULL;
+		}
+		insertedIds.clear();
+		return true;
+	}).wait();
 
+	// Every queued job has run, apply what they reported
+	Poll();
 	return 0;
 }
 
-void Annotations::GenerateList(void) {
+std::vector<Annotation> Annotations::GenerateList(void) {
+	std::vector<Annotation> annotations;
 	sqlite3_stmt *stmt;
-	char sql[] = "SELECT id,side,posx,posy,net,part,pin,note from annotations where visible=1;";
+	char sql[] = "SELECT id,side,posx,posy,net,part,pin,note from annotations where visible=1 order by id;";
 	int rc;
 
+	if (!sqldb) return annotations;
 	rc = sqlite3_prepare_v2(sqldb, sql, -1, &stmt, NULL);
 	if (rc != SQLITE_OK) {
 		if (debug) std::cerr << "SELECT failed: " << sqlite3_errmsg(sqldb) << std::endl;
-		return; // or throw
+		return annotations; // or throw
 	}
 
-	annotations.clear();
 	while ((rc = sqlite3_step(stmt)) == SQLITE_ROW) {
 		Annotation ann;
 		ann.id      = sqlite3_column_int(stmt, 0);
@@ -138,60 +240,230 @@ void Annotations::GenerateList(void) {
 		// if you return/throw here, don't forget the finalize
 	}
 	sqlite3_finalize(stmt);
+	return annotations;
 }
 
-void Annotations::Add(int side, double x, double y, const char *net, const char *part, const char *pin, const char *note) {
-	char sql[10240];
-	char *zErrMsg = 0;
-	int r;
-
-	sqlite3_snprintf(sizeof(sql),
-	                 sql,
-	                 "INSERT into annotations ( visible, side, posx, posy, net, part, pin, note ) \
-			values ( 1, %d, %0.0f, %0.0f, '%s', '%s', '%s', '%q' );",
-	                 side,
-	                 x,
-	                 y,
-	                 net,
-	                 part,
-	                 pin,
-	                 note);
-
-	r = sqlite3_exec(sqldb, sql, NULL, 0, &zErrMsg);
-	if (r != SQLITE_OK) {
-		if (debug) fprintf(stderr, "SQL error: %s\n", zErrMsg);
-		sqlite3_free(zErrMsg);
-	} else {
-		if (debug) fprintf(stdout, "Records created successfully\n");
+bool Annotations::Poll(void) {
+	bool changed = false;
+
+	// Jobs run in order, once the rows are read every earlier insert has reported too
+	bool loaded = loading.valid() && loading.wait_for(std::chrono::seconds(0)) == std::future_status::ready;
+
+	for (auto it = pendingAdds.begin(); it != pendingAdds.end();) {
+		if (it->id.wait_for(std::chrono::seconds(0)) != std::future_status::ready) {
+			++it;
+			continue;
+		}
+		int id = it->id.get();
+		for (auto ann = annotations.begin(); ann != annotations.end(); ++ann) {
+			if (ann->id != it->tempId) continue;
+			if (id >= 0) {
+				ann->id = id;
+				for (auto &edit : localEdits)
+					if (edit.id == it->tempId) edit.id = id;
+			} else {
+				annotations.erase(ann); // the insert failed, take the note back
+				indexed = false;
+				changed = true;
+			}
+			break;
+		}
+		it = pendingAdds.erase(it);
+	}
+
+	bool failed = false;
+	for (auto it = pendingWrites.begin(); it != pendingWrites.end();) {
+		if (it->wait_for(std::chrono::seconds(0)) != std::future_status::ready) {
+			++it;
+			continue;
+		}
+		failed |= !it->get();
+		it = pendingWrites.erase(it);
+	}
+	failed |= batchFailed.exchange(false);
+
+	if (loaded) {
+		auto list = loading.get();
+
+		// Edits queued after the load are not in the rows yet, apply them again
+		for (auto &edit : localEdits) {
+			auto ann = std::find_if(list.begin(), list.end(), [&edit](const Annotation &a) { return a.id == edit.id; });
+			if (ann == list.end()) continue;
+			if (edit.removed)
+				list.erase(ann);
+			else
+				ann->note = edit.note;
+		}
+		localEdits.clear();
+
+		// Notes added after the rows were read are not in the list yet, keep them
+		int last = list.empty() ? 0 : list.back().id;
+		for (auto &ann : annotations)
+			if (ann.id < 0 || ann.id > last) list.push_back(ann);
+		annotations.swap(list);
+		indexed = false;
+		changed = true;
 	}
+
+	// After the loaded rows are taken, the new load must not be waited for here
+	if (failed) Reload(); // show what the database really holds
+
+	return changed;
 }
 
-void Annotations::Remove(int id) {
-	char sql[1024];
-	char *zErrMsg = 0;
-	int r;
+bool Annotations::Busy(void) const {
+	return loading.valid() || !pendingAdds.empty() || !pendingWrites.empty();
+}
 
-	sqlite3_snprintf(sizeof(sql), sql, "UPDATE annotations set visible = 0 where id=%d;", id);
-	r = sqlite3_exec(sqldb, sql, NULL, 0, &zErrMsg);
-	if (r != SQLITE_OK) {
-		if (debug) fprintf(stderr, "SQL error: %s\n", zErrMsg);
-		sqlite3_free(zErrMsg);
-	} else {
-		if (debug) fprintf(stdout, "Records created successfully\n");
+void Annotations::Reindex(void) {
+	grid[0].Build(annotations, 0);
+	grid[1].Build(annotations, 1);
+	indexed = true;
+}
+
+void Annotations::Query(int side, float x0, float y0, float x1, float y1, std::vector<uint32_t> &out) {
+	out.clear();
+	if (side < 0 || side > 1) return;
+	if (!indexed) Reindex(); // batched edits only pay for one rebuild
+	grid[side].Query(annotations, x0, y0, x1, y1, out);
+	std::sort(out.begin(), out.end());
+}
+
+/*
+ * About two notes per cell over the bounding box of the side's notes,
+ * built counting sort style so a cell's notes are contiguous.
+ */
+void AnnotationGrid::Build(const std::vector<Annotation> &annotations, int side) {
+	float maxx = 0.0f, maxy = 0.0f;
+	size_t count = 0;
+	for (auto &ann : annotations) {
+		if (ann.side != side) continue;
+		if (!count) {
+			minx = maxx = ann.x;
+			miny = maxy = ann.y;
+		}
+		minx = std::min(minx, float(ann.x));
+		miny = std::min(miny, float(ann.y));
+		maxx = std::max(maxx, float(ann.x));
+		maxy = std::max(maxy, float(ann.y));
+		count++;
+	}
+
+	items.clear();
+	cellStart.clear();
+	if (!count) {
+		cols = rows = 0;
+		return;
+	}
+
+	int side_cells = std::max(1, int(std::sqrt(count / 2.0)));
+	cell           = std::max({maxx - minx, maxy - miny, 1.0f}) / side_cells;
+	cols           = int((maxx - minx) / cell) + 1;
+	rows           = int((maxy - miny) / cell) + 1;
+
+	auto cellOf = [&](const Annotation &ann) {
+		int cx = std::min(cols - 1, int((ann.x - minx) / cell));
+		int cy = std::min(rows - 1, int((ann.y - miny) / cell));
+		return cy * cols + cx;
+	};
+
+	cellStart.assign(cols * rows + 1, 0);
+	for (auto &ann : annotations)
+		if (ann.side == side) cellStart[cellOf(ann) + 1]++;
+	for (size_t c = 1; c < cellStart.size(); c++) cellStart[c] += cellStart[c - 1];
+
+	std::vector<uint32_t> fill(cellStart.begin(), cellStart.end() - 1);
+	items.resize(count);
+	for (uint32_t i = 0; i < annotations.size(); i++)
+		if (annotations[i].side == side) items[fill[cellOf(annotations[i])]++] = i;
+}
+
+void AnnotationGrid::Query(
+    const std::vector<Annotation> &annotations, float x0, float y0, float x1, float y1, std::vector<uint32_t> &out) const {
+	if (!cols || x1 < x0 || y1 < y0) return;
+
+	// clamped as floats, a zoomed out view can be far larger than the grid
+	auto cellIndex = [](float v, int count) { return v <= 0.0f ? 0 : v >= count - 1 ? count - 1 : int(v); };
+	int cx0        = cellIndex((x0 - minx) / cell, cols);
+	int cy0        = cellIndex((y0 - miny) / cell, rows);
+	int cx1        = cellIndex((x1 - minx) / cell, cols);
+	int cy1        = cellIndex((y1 - miny) / cell, rows);
+
+	for (int cy = cy0; cy <= cy1; cy++) {
+		for (int cx = cx0; cx <= cx1; cx++) {
+			int c = cy * cols + cx;
+			for (uint32_t k = cellStart[c]; k < cellStart[c + 1]; k++) {
+				auto &ann = annotations[items[k]];
+				if (ann.x >= x0 && ann.x <= x1 && ann.y >= y0 && ann.y <= y1) out.push_back(items[k]);
+			}
+		}
 	}
 }
 
-void Annotations::Update(int id, char *note) {
-	char sql[10240];
-	char *zErrMsg = 0;
-	int r;
+int Annotations::Add(int side, double x, double y, const char *net, const char *part, const char *pin, const char *note) {
+	Annotation ann;
+	ann.id      = nextTempId--;
+	ann.side    = side;
+	ann.x       = std::lround(x); // stored as integers
+	ann.y       = std::lround(y);
+	ann.net     = net;
+	ann.part    = part;
+	ann.pin     = pin;
+	ann.note    = note;
+	ann.hovered = false;
+	annotations.push_back(ann);
+	indexed = false;
 
-	sqlite3_snprintf(sizeof(sql), sql, "UPDATE annotations set note = '%q' where id=%d;", note, id);
-	r = sqlite3_exec(sqldb, sql, NULL, 0, &zErrMsg);
-	if (r != SQLITE_OK) {
-		if (debug) fprintf(stderr, "SQL error: %s\n", zErrMsg);
-		sqlite3_free(zErrMsg);
-	} else {
+	PendingAdd pending;
+	pending.tempId = ann.id;
+	pending.id     = SubmitWrite<int>([this, ann] {
+		sqlite3_bind_int(insertStmt, 1, ann.side);
+		sqlite3_bind_int(insertStmt, 2, ann.x);
+		sqlite3_bind_int(insertStmt, 3, ann.y);
+		sqlite3_bind_text(insertStmt, 4, ann.net.c_str(), -1, SQLITE_STATIC);
+		sqlite3_bind_text(insertStmt, 5, ann.part.c_str(), -1, SQLITE_STATIC);
+		sqlite3_bind_text(insertStmt, 6, ann.pin.c_str(), -1, SQLITE_STATIC);
+		sqlite3_bind_text(insertStmt, 7, ann.note.c_str(), -1, SQLITE_STATIC);
+		if (!Run(insertStmt)) return -1;
 		if (debug) fprintf(stdout, "Records created successfully\n");
+
+		int id = sqlite3_last_insert_rowid(sqldb);
+		insertedIds[ann.id] = id;
+		return id;
+	});
+	pendingAdds.push_back(std::move(pending));
+	return ann.id;
+}
+
+void Annotations::Remove(int id) {
+	for (auto it = annotations.begin(); it != annotations.end(); ++it) {
+		if (it->id == id) {
+			annotations.erase(it);
+			break;
+		}
 	}
+	indexed = false;
+	if (loading.valid()) localEdits.push_back({id, true, std::string()});
+
+	pendingWrites.push_back(SubmitWrite<bool>([this, id] {
+		sqlite3_bind_int(removeStmt, 1, RowId(id));
+		return Run(removeStmt);
+	}));
+}
+
+void Annotations::Update(int id, const char *note) {
+	for (auto &ann : annotations) {
+		if (ann.id == id) {
+			ann.note = note;
+			break;
+		}
+	}
+
+	std::string text = note;
+	if (loading.valid()) localEdits.push_back({id, false, text});
+	pendingWrites.push_back(SubmitWrite<bool>([this, id, text] {
+		sqlite3_bind_text(updateStmt, 1, text.c_str(), -1, SQLITE_STATIC);
+		sqlite3_bind_int(updateStmt, 2, RowId(id));
+		return Run(updateStmt);
+	}));
 }
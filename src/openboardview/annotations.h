@@ -1,4 +1,13 @@
 #include "sqlite3.h"
+#include "WorkerPool.h"
+
+#include <atomic>
+#include <cstdint>
+#include <functional>
+#include <future>
+#include <string>
+#include <unordered_map>
+#include <vector>
 
 #ifndef __ANNOTATIONS
 #define __ANNOTATIONS
@@ -12,21 +21,93 @@ struct Annotation {
 	bool hovered;
 };
 
+// Uniform grid over the annotation positions of one board side
+struct AnnotationGrid {
+	float minx = 0.0f, miny = 0.0f, cell = 1.0f;
+	int cols = 0, rows = 0;
+	std::vector<uint32_t> cellStart; // cols * rows + 1 offsets in items
+	std::vector<uint32_t> items;     // annotation indices, cell by cell
+
+	void Build(const std::vector<Annotation> &annotations, int side);
+	// Append the indices of the annotations positioned within [x0,x1]x[y0,y1]
+	void Query(const std::vector<Annotation> &annotations, float x0, float y0, float x1, float y1, std::vector<uint32_t> &out) const;
+};
+
+/*
+ * The database lives on its own I/O thread: edits change annotations right
+ * away and queue the matching SQL, Poll() then applies what the thread
+ * reports back (loaded rows, ids of added notes, failed writes).
+ */
 struct Annotations {
 	std::string filename;
-	sqlite3 *sqldb;
 	bool debug = false;
-	std::vector<Annotation> annotations;
+	std::vector<Annotation> annotations; // UI side, edits show here before they reach the database
+	AnnotationGrid grid[2];              // per side, see Reindex()
+	bool indexed = false;                // grid matches annotations
+
+	// Database state, only used by jobs on the I/O thread
+	sqlite3 *sqldb           = nullptr;
+	sqlite3_stmt *insertStmt = nullptr;
+	sqlite3_stmt *removeStmt = nullptr;
+	sqlite3_stmt *updateStmt = nullptr;
+	sqlite3_stmt *beginStmt  = nullptr;
+	sqlite3_stmt *commitStmt = nullptr;
+	bool transaction         = false;        // a batch of writes is open
+	std::unordered_map<int, int> insertedIds; // temporary id of an added note -> its row id
+
+	// Writes queued one after the other share a transaction, committed by the last of them
+	std::atomic<int> queuedWrites{0};
+	std::atomic<bool> batchFailed{false}; // a commit failed, Poll() reloads
 
+	// Replies Poll() has yet to apply
+	struct PendingAdd {
+		int tempId;
+		std::future<int> id; // row id, or -1 when the insert failed
+	};
+	// Edit queued after the running load, applied again to the rows it reads
+	struct LocalEdit {
+		int id;
+		bool removed;
+		std::string note;
+	};
+	std::future<std::vector<Annotation>> loading;
+	std::vector<LocalEdit> localEdits;
+	std::vector<PendingAdd> pendingAdds;
+	std::vector<std::future<bool>> pendingWrites;
+	int nextTempId = -1; // added notes have negative ids until their row exists
+	std::function<void()> notify; // called on the I/O thread when a reply is ready for Poll()
+
+	WorkerPool io{1}; // last, so that queued jobs finish before the members above go
+
+	// I/O thread side
 	int Init(void);
+	int Prepare(void);
+	bool Run(sqlite3_stmt *stmt);
+	int RowId(int id);
+	std::vector<Annotation> GenerateList(void);
+	template <class R> std::future<R> Submit(std::function<R()> job);
+	template <class R> std::future<R> SubmitWrite(std::function<R()> write);
 
 	int SetFilename(const std::string &f);
+	// Open the database and read the notes in the background
 	int Load(void);
+	// Wait for the queued writes and close the database
 	int Close(void);
+
 	void Remove(int id);
-	void Add(int side, double x, double y, const char *net, const char *part, const char *pin, const char *note);
-	void Update(int id, char *note);
-	void GenerateList(void);
+	int Add(int side, double x, double y, const char *net, const char *part, const char *pin, const char *note);
+	void Update(int id, const char *note);
+	void Reload(void);
+
+	// Apply the I/O thread replies, true when annotations changed
+	bool Poll(void);
+	// Whether replies are still to come
+	bool Busy(void) const;
+
+	// Rebuild the grids, needed after moving annotations; adding and removing rebuild on the next Query()
+	void Reindex(void);
+	// Indices in annotations of the side's notes positioned within the box, in list order
+	void Query(int side, float x0, float y0, float x1, float y1, std::vector<uint32_t> &out);
 };
 
 #endif
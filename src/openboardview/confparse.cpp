@@ -1,3 +1,4 @@
+#include <algorithm>
 #include <cerrno>
 #include <fstream>
 #include <iostream>
@@ -9,6 +10,12 @@
 #include "confparse.h"
 #include "version.h"
 
+#ifdef _WIN32
+#include <io.h>
+#else
+#include <unistd.h>
+#endif
+
 /*
  * XRayBlue theme - by Inflex
  */
@@ -42,6 +49,13 @@ pinSizeThresholdLow = 0\r\n\
 pinShapeCircle = true\r\n\
 pinShapeSquare = false\r\n\
 \r\n\
+# Level of detail, on-screen sizes in pixels below which pins/parts get simplified (0 = off)\r\n\
+lodPinTileSize = 1\r\n\
+lodPinSimpleSize = 3\r\n\
+lodPartRectSize = 10\r\n\
+lodPartSimpleSize = 40\r\n\
+lodTileSize = 4\r\n\
+\r\n\
 slowCPU =       false\r\n\
 showFPS =       false\r\n\
 pinHalo =       false\r\n\
@@ -51,6 +65,7 @@ pinHaloThickness = 4\r\n\
 fillParts =		true\r\n\
 showPartName =  true\r\n\
 showPinName =  true\r\n\
+labelCollisionCulling = true\r\n\
 boardFill =		true\r\n\
 boardFillSpacing = 3\r\n\
 \r\n\
@@ -238,13 +253,17 @@ int Confparse::SaveDefault(const filesystem::path &filepath) {
 }
 
 int Confparse::Load(const filesystem::path &filepath, bool save_default) {
+	edits.clear(); // unsaved writes were against the previous text
 	ifstream file;
 	file.open(filepath, std::ios::in | std::ios::binary | std::ios::ate);
 	if (!file.is_open()) {
 		//		std::cerr << "Error opening " << filepath.string() << ": " <<
 		// strerror(errno) << std::endl;
+		if (conf) free(conf);
 		buffer_size = 0;
 		conf        = NULL;
+		limit       = NULL;
+		entries.clear();
 		if (nested) return 1; // to prevent infinite recursion, we test the nested flag
 		if (save_default) { // Create file with default OBV configuration
 			return (SaveDefault(filepath));
@@ -268,6 +287,7 @@ int Confparse::Load(const filesystem::path &filepath, bool save_default) {
 	file.read(conf, sz);
 	limit = conf + sz;
 	file.close();
+	Index();
 
 	if (file.gcount() != sz) {
 		std::cerr << "Did not read the right number of bytes from configuration file " << file.gcount() << " != " << sz << std::endl;
@@ -282,85 +302,47 @@ int Confparse::Load(const filesystem::path &filepath, bool save_default) {
 	return 0;
 }
 
-char *Confparse::Parse(const char *key) {
-	char *p, *op;
-	char *llimit;
-	int keylen;
-
-	value[0] = '\0';
-
-	if (!conf) return NULL;
-	if (!key) return NULL;
-
-	if (!conf[0]) return NULL;
-	if (!key[0]) return NULL;
-
-	keylen = strlen(key);
-	if (keylen == 0) return NULL;
-
-	p = strstr(conf, key);
-	if (p == NULL) {
-		return NULL;
+/*
+ * Split the text into key = value lines once, lookups are then a hash
+ * table access. Like the text search this replaces, the key has to start
+ * the line and is followed by any run of '=', spaces or tabs; the first
+ * line of a key wins.
+ */
+void Confparse::Index() {
+	entries.clear();
+	if (!conf) return;
+
+	const char *line = conf;
+	while (line < limit) {
+		const char *eol = line;
+		while ((eol < limit) && (*eol != '\0') && (*eol != '\n') && (*eol != '\r')) eol++;
+
+		const char *p = line;
+		while ((p < eol) && (*p != '=') && (*p != ' ') && (*p != '\t')) p++;
+		if (p > line) {
+			std::string key(line, p);
+			while ((p < eol) && ((*p == '=') || (*p == ' ') || (*p == '\t'))) p++;
+
+			Entry entry;
+			entry.valueBegin = p - conf;
+			entry.valueEnd   = eol - conf;
+			entry.value.assign(p, eol);
+			entries.emplace(std::move(key), std::move(entry));
+		}
+		line = eol + 1;
 	}
+}
 
-	op = p;
-
-	llimit = limit; // - keylen - 2; // allows for up to 'key=x'
-
-	while (p && p < llimit) {
-
-		/*
-		 * Consume the name<whitespace>=<whitespace> trash before we
-		 * get to the actual value.  While this does mean things are
-		 * slightly less strict in the configuration file text it can
-		 * assist in making it easier for people to read it.
-		 */
-		p = p + keylen;
-
-		if ((p < llimit) && (!isalnum(*p))) {
-
-			while ((p < llimit) && ((*p == '=') || (*p == ' ') || (*p == '\t'))) p++; // get up to the start of the value;
-
-			if ((p < llimit) && (p >= conf)) {
-
-				/*
-				 * Check that the location of the strstr() return is
-				 * left aligned to the start of the line. This prevents
-				 * us picking up trash name=value pairs among the general
-				 * text within the file
-				 */
-				if ((op == conf) || (*(op - 1) == '\r') || (*(op - 1) == '\n')) {
-					size_t i = 0;
-
-					/*
-					 * Search for the end of the data by finding the end of the line
-					 */
-					while ((p < limit) && ((*p != '\0') && (*p != '\n') && (*p != '\r'))) {
-						value[i] = *p;
-						p++;
-						i++;
-						if (i >= CONFPARSE_MAX_VALUE_SIZE) break;
-					}
-					value[i] = '\0';
-					return value;
-				}
-			}
-		}
+const char *Confparse::Parse(const char *key) {
+	if (!key) return NULL;
 
-		// if the previous strstr() was a non-success, then try search again from the next bit
-		if (op < limit) {
-			p = strstr(op + 1, key);
-			if (!p) break;
-			op = p;
-		} else {
-			break;
-		}
-	}
-	return NULL;
+	auto it = entries.find(key);
+	if (it == entries.end()) return NULL;
+	return it->second.value.c_str();
 }
 
 const char *Confparse::ParseStr(const char *key, const char *defaultv) {
-	char *p = Parse(key);
+	const char *p = Parse(key);
 	if (p)
 		return p;
 	else
@@ -368,9 +350,10 @@ const char *Confparse::ParseStr(const char *key, const char *defaultv) {
 }
 
 int Confparse::ParseInt(const char *key, int defaultv) {
-	char *p = Parse(key);
+	const char *p = Parse(key);
 	if (p) {
-		int v = strtol((char *)Parse(key), NULL, 10);
+		errno = 0;
+		int v = strtol(p, NULL, 10);
 		if (errno == ERANGE)
 			return defaultv;
 		else
@@ -380,13 +363,14 @@ int Confparse::ParseInt(const char *key, int defaultv) {
 }
 
 uint32_t Confparse::ParseHex(const char *key, uint32_t defaultv) {
-	char *p = Parse(key);
+	const char *p = Parse(key);
 	if (p) {
 		uint32_t v;
 		if ((*p == '0') && (*(p + 1) == 'x')) {
 			p += 2;
 		}
-		v = strtoul(p, NULL, 16);
+		errno = 0;
+		v     = strtoul(p, NULL, 16);
 		if (errno == ERANGE)
 			return defaultv;
 		else
@@ -396,8 +380,9 @@ uint32_t Confparse::ParseHex(const char *key, uint32_t defaultv) {
 }
 
 double Confparse::ParseDouble(const char *key, double defaultv) {
-	char *p = Parse(key);
+	const char *p = Parse(key);
 	if (p) {
+		errno    = 0;
 		double v = strtod(p, NULL);
 		if (errno == ERANGE)
 			return defaultv;
@@ -409,7 +394,7 @@ double Confparse::ParseDouble(const char *key, double defaultv) {
 }
 
 bool Confparse::ParseBool(const char *key, bool defaultv) {
-	char *p = Parse(key);
+	const char *p = Parse(key);
 	if (p) {
 		if (strncmp(p, "true", sizeof("true")) == 0) {
 			return true;
@@ -422,133 +407,121 @@ bool Confparse::ParseBool(const char *key, bool defaultv) {
 /*
  * Write parts
  *
+ * Writes only update the in-memory text, Save() puts it on disk in one go
+ * by writing a temporary file next to the configuration and renaming it
+ * over, so a crash never leaves a half written configuration behind.
  */
-bool Confparse::WriteStr(const char *key, const char *value) {
-	char *p, *op;
-	char *llimit;
-	int keylen;
-
-	if (!conf) return false;
-	if (filepath.empty()) return false;
-	if (!value) return false;
-	if (!key) return false;
+void Confparse::Begin() {
+	transaction++;
+}
 
-	keylen = strlen(key);
-	if (keylen == 0) return false;
-	op = p = strstr(conf, key);
-	if (p == NULL) {
-		char buf[1024];
-		size_t bs;
-		auto nfn = filepath;
-		nfn += "~";
-		ofstream file;
-
-		filesystem::rename(filepath, nfn);
-		file.open(filepath, std::ios::out | std::ios::binary | std::ios::trunc);
-		if (!file.is_open()) {
-			return false;
-		}
-		file.write(conf, buffer_size); // write the leadup
-		bs = snprintf(buf, sizeof(buf), "\r\n%s = %s", key, value);
-		file.write(buf, bs);
-		file.flush();
-		file.close();
+bool Confparse::Commit() {
+	if (transaction > 0) transaction--;
+	if (transaction > 0) return true; // nested, the outermost Commit() saves
+	return Save();
+}
 
-		Load(filepath);
-		return true;
-	}
+bool Confparse::Save() {
+	if (edits.empty()) return true;
 
-	//	llimit = limit - keylen - 2; // allows for up to 'key=x'
-	llimit = limit;
-	while (p && p < llimit) {
-
-		/*
-		 * Consume the name<whitespace>=<whitespace> trash before we
-		 * get to the actual value.  While this does mean things are
-		 * slightly less strict in the configuration file text it can
-		 * assist in making it easier for people to read it.
-		 */
-		p = p + keylen;
-		if ((p < llimit) && (!isalnum(*p))) {
-
-			while ((p < llimit) && ((*p == '=') || (*p == ' ') || (*p == '\t'))) {
-				p++; // get up to the start of the value;
-			}
-
-			if ((p < llimit) && (p >= conf)) {
-
-				/*
-				 * Check that the location of the strstr() return is
-				 * left aligned to the start of the line. This prevents
-				 * us picking up trash name=value pairs among the general
-				 * text within the file
-				 */
-				if ((op == conf) || (*(op - 1) == '\r') || (*(op - 1) == '\n')) {
-					char *ep = NULL;
-
-					/*
-					 * op represents the start of the line/key.
-					 * p represents the start of the value.
-					 *
-					 * we can just dump out to the file up to p and then
-					 * print our data
-					 */
-
-					/*
-					 * Search for the end of the data by finding the end of the line
-					 * This will become 'ep', which we'll use as the start of the
-					 * rest of the file data we dump back to the config.
-					 */
-					ep = p;
-					while ((ep < limit) && ((*ep != '\0') && (*ep != '\n') && (*ep != '\r'))) {
-						ep++;
-					}
-
-					{
-						auto nfn = filepath;
-						nfn += "~";
-						ofstream file;
-
-						filesystem::rename(filepath, nfn);
-						file.open(filepath, std::ios::out | std::ios::binary | std::ios::trunc);
-						if (!file.is_open()) {
-							return false;
-						}
-						file.write(conf, (p - conf));     // write the leadup
-						file.write(value, strlen(value)); // write the new data
-						file.write(ep, limit - ep);       // write the rest of the file
-						file.close();
-
-						Load(filepath);
-						return true;
-					}
-				}
-			}
+	/*
+	 * Splice the new values into the loaded text, in file order,
+	 * and append the keys it doesn't have yet
+	 */
+	std::vector<std::pair<const Entry *, const std::string *>> replaced;
+	std::string appended;
+	for (auto &edit : edits) {
+		auto &entry = entries[edit.first];
+		if (entry.valueBegin <= buffer_size) {
+			replaced.emplace_back(&entry, &edit.second);
+		} else {
+			appended += edit.first + " = " + edit.second + "\r\n";
 		}
-		p  = strstr(op + 1, key);
-		op = p;
+	}
+	std::sort(replaced.begin(), replaced.end(), [](const std::pair<const Entry *, const std::string *> &a,
+	                                               const std::pair<const Entry *, const std::string *> &b) {
+		return a.first->valueBegin < b.first->valueBegin;
+	});
+
+	std::string text;
+	size_t pos = 0;
+	for (auto &r : replaced) {
+		text.append(conf + pos, r.first->valueBegin - pos); // write the leadup
+		text += *r.second;                                  // write the new data
+		pos = r.first->valueEnd;
+	}
+	text.append(conf + pos, buffer_size - pos); // write the rest of the file
+	if (!appended.empty()) {
+		if (!text.empty() && (text.back() != '\n') && (text.back() != '\r')) text += "\r\n";
+		text += appended;
+	}
+	edits.clear();
+
+	auto tmp = filepath;
+	tmp += ".tmp";
+	FILE *f;
+#ifdef _WIN32
+	if (_wfopen_s(&f, tmp.wstring().c_str(), L"wb") != 0) f = NULL;
+#else
+	f = fopen(tmp.c_str(), "wb");
+#endif
+	bool written = f != NULL;
+	if (f) {
+		written = fwrite(text.data(), 1, text.size(), f) == text.size();
+		written &= fflush(f) == 0;
+#ifdef _WIN32
+		written &= _commit(_fileno(f)) == 0;
+#else
+		written &= fsync(fileno(f)) == 0;
+#endif
+		written &= fclose(f) == 0;
+	}
+	std::error_code ec;
+	if (written) filesystem::rename(tmp, filepath, ec);
+	if (!written || ec) {
+		std::cerr << "Could not save configuration file " << filepath.string() << std::endl;
+		filesystem::remove(tmp, ec);
+		Load(filepath); // back to what is on disk
+		return false;
 	}
 
+	// The file now holds text, no need to read it back
+	free(conf);
+	buffer_size = text.size();
+	conf        = (char *)calloc(1, buffer_size + 1);
+	memcpy(conf, text.data(), buffer_size);
+	limit = conf + buffer_size;
+	Index();
+	return true;
+}
+
+bool Confparse::WriteStr(const char *key, const char *value) {
+	if (!conf) return false;
+	if (filepath.empty()) return false;
+	if (!value) return false;
+	if (!key) return false;
+	if (!key[0]) return false;
+
 	/*
-	 * If we didn't find our parameter in the config file, then add it.
+	 * Keys not in the file yet get an entry past the end of the text,
+	 * so that Parse() sees the new value before it is saved
 	 */
-	{
-		char sep[CONFPARSE_MAX_VALUE_SIZE];
-		ofstream file;
-		file.open(filepath, std::ios::out | std::ios::binary | std::ios::app);
-		if (!file.is_open()) {
-			return false;
+	auto it = entries.find(key);
+	if (it == entries.end()) it = entries.emplace(key, Entry()).first;
+	it->second.value = value;
+
+	bool found = false;
+	for (auto &edit : edits) {
+		if (edit.first == key) {
+			edit.second = value;
+			found       = true;
+			break;
 		}
-		snprintf(sep, sizeof(sep), "%s = %s\r\n", key, value);
-		file.write(sep, strlen(sep));
-		file.flush();
-		file.close();
-
-		Load(filepath);
-		return true;
 	}
+	if (!found) edits.emplace_back(key, value);
 
-	return false;
+	if (transaction > 0) return true;
+	return Save();
 }
 
 bool Confparse::WriteBool(const char *key, bool value) {
@@ -1,28 +1,46 @@
 #ifndef __CONFPARSE__
 #define __CONFPARSE__
 #include <string>
+#include <unordered_map>
+#include <utility>
+#include <vector>
 
 #include "filesystem_impl.h"
 
-#define CONFPARSE_MAX_VALUE_SIZE 10240
 struct Confparse {
+	// A key = value line of the loaded text, offsets are in conf
+	struct Entry {
+		size_t valueBegin = std::string::npos; // value up to the end of the line, npos when not in the text yet
+		size_t valueEnd   = std::string::npos;
+		std::string value;
+	};
 
 	filesystem::path filepath;
-	char value[CONFPARSE_MAX_VALUE_SIZE];
-	char *conf, *limit;
-	size_t buffer_size;
-	bool nested = false;
+	char *conf         = nullptr;
+	char *limit        = nullptr;
+	size_t buffer_size = 0;
+	bool nested        = false;
+	std::unordered_map<std::string, Entry> entries; // first line of each key, built by Load()
+
+	// Writes between Begin() and Commit() are kept in memory and saved at once
+	int transaction = 0;
+	std::vector<std::pair<std::string, std::string>> edits; // key, new value
 
 	~Confparse(void);
 	int Load(const filesystem::path &filepath, bool save_default = false);
 	int SaveDefault(const filesystem::path &filepath);
-	char *Parse(const char *key);
+	void Index();
+	const char *Parse(const char *key);
 	const char *ParseStr(const char *key, const char *defaultv);
 	double ParseDouble(const char *key, double defaultv);
 	int ParseInt(const char *key, int defaultv);
 	bool ParseBool(const char *key, bool defaultv);
 	uint32_t ParseHex(const char *key, uint32_t defaultv);
 
+	void Begin();
+	bool Commit();
+	bool Save();
+
 	bool WriteStr(const char *key, const char *value);
 	bool WriteBool(const char *key, bool value);
 	bool WriteInt(const char *key, int value);
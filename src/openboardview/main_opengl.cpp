@@ -13,6 +13,7 @@
 #include "version.h"
 
 #include "BoardView.h"
+#include "Trace.h"
 #include "history.h"
 
 #include "confparse.h"
@@ -55,6 +56,8 @@ struct globals {
 	int dpi = 0;
 	float font_size = 0.0f;
 	bool debug = false;
+	char *trace_file = nullptr;
+	int trace_frames = 300;
 	Renderers::Renderer renderer = Renderers::Renderer::DEFAULT;
 #ifdef _WIN32
 	char *pdfBridgePdfPath = nullptr;
@@ -65,7 +68,7 @@ struct globals {
 static SDL_Window *window      = nullptr;
 
 char help[] =
-    " [-h] [-V] [-l] [-c <config file>] [-i <intput file>] [-x <width>] [-y <height>] [-z <fontsize>] [-p <dpi>] [-r <renderer>] [-d]\n\
+    " [-h] [-V] [-l] [-c <config file>] [-i <intput file>] [-x <width>] [-y <height>] [-z <fontsize>] [-p <dpi>] [-r <renderer>] [-d] [-t <trace file>] [-T <frames>]\n\
 	-h : This help\n\
 	-V : Version information\n\
 	-l : slow CPU mode, disables AA and other items to try provide more FPS\n\
@@ -78,6 +81,8 @@ char help[] =
 	-p <dpi> : Set the dpi\n\
 	-r <renderer> : Set the renderer [ OPENGL1 = 1; OPENGL3 = 2; OPENGLES2 = 3 ]\n\
 	-d : Debug mode\n\
+	-t <trace file> : Record to a Chrome trace JSON file from startup until <frames> frames after a board load\n\
+	-T <frames> : Number of frames traced after a board load, frames before the first load do not count (default 300)\n\
 ";
 
 int parse_parameters(int argc, char **argv, struct globals *g) {
@@ -168,6 +173,24 @@ int parse_parameters(int argc, char **argv, struct globals *g) {
 				exit(1);
 			}
 
+		} else if (strcmp(p, "-t") == 0) {
+			param++;
+			if ((param < argc)&&(argv[param][0] != '-')) {
+				g->trace_file = argv[param];
+			} else {
+				SDL_LogError(SDL_LOG_CATEGORY_ERROR, "Not enough paramters for -t <trace file>\n\n%s %s", argv[0], help );
+				exit(1);
+			}
+
+		} else if (strcmp(p, "-T") == 0) {
+			param++;
+			if ((param < argc)&&(argv[param][0] != '-')) {
+				g->trace_frames = strtol(argv[param], NULL, 10);
+			} else {
+				SDL_LogError(SDL_LOG_CATEGORY_ERROR, "Not enough paramters for -T <frames>\n\n%s %s", argv[0], help );
+				exit(1);
+			}
+
 		} else if (strcmp(p, "-l") == 0) {
 			g->slowCPU = true;
 
@@ -212,7 +235,6 @@ void cleanupAndExit(int c) {
 }
 
 int main(int argc, char **argv) {
-	uint8_t sleepout;
 	std::string configDir;
 	globals g; // because some things we have to store *before* we load the config file in BoardView app.obvconf
 	BoardView app{};
@@ -234,6 +256,7 @@ int main(int argc, char **argv) {
 	parse_parameters(argc, argv, &g);
 
 	app.debug = g.debug;
+	if (g.trace_file) Trace::start(g.trace_file, g.trace_frames);
 
 	// Setup SDL
 	if (SDL_Init(SDL_INIT_VIDEO | SDL_INIT_TIMER) != 0) {
@@ -374,56 +397,90 @@ int main(int argc, char **argv) {
 	}
 
 	/*
-	 * The sleepout var keeps track of how many iterations of the main loop
-	 * are left, without an event having happened before OBV will start to sleep
-	 * and continue without redrawing the page.
-	 *
-	 * The reason we don't just sleep immediately after a non-event is because
-	 * sometimes there are internal things that still need to be done on the next
-	 * render (such as responding to a mouse click
-	 *
-	 * For now we've got this set to 3 frames which seems to work okay with OBV.
-	 * If you find some things aren't working properly without you having to move
-	 * the mouse or 'waking up' OBV then increase to 5 or more.
+	 * The main loop sleeps in SDL until something happens: input, a window
+	 * event, or a request_frame() from a background job (search results,
+	 * annotations, the PDF viewer). A few frames are rendered after each
+	 * event since ImGui often needs them to settle (hover state, popups,
+	 * closing menus), and widgets animating with time are given a tick:
+	 * hover delays for a moment after the last input, the text cursor
+	 * while typing, and bridges that have to poll their viewer.
 	 */
-	sleepout = 30;
+	static const int settleFrames = 3;
+	static const Uint32 lingerMs  = 1000; // after the last event, for tooltip delays and such
+	int settle                    = settleFrames;
+	Uint32 lastEvent              = SDL_GetTicks();
+	std::chrono::steady_clock::time_point nextFrame;
 	float angleacc = 0.0;
-	while (!done) {
 
-		SDL_Event event;
-		while (SDL_PollEvent(&event)) {
-			sleepout = 30;
-			Renderers::current->processEvent(event);
-
-			if (event.type == SDL_DROPFILE) {
-				app.LoadFile(filesystem::u8path(event.drop.file));
-			} else if(event.type == SDL_MULTIGESTURE && event.mgesture.numFingers == 2 && !ImGui::IsMouseDown(ImGuiMouseButton_Left)) {
-				//Inhibit dragging board area
-				app.m_dragging_token = -1;
-				//Rotation detected, at least 1°
-				if (fabs(event.mgesture.dTheta) > 3.14 / 180.0) {
-					angleacc += event.mgesture.dTheta;
-					if (angleacc >= 3.14 / 2) {
-						// > 90°
-						app.Rotate(1);
-						angleacc = 0.0;
-					} else if (angleacc <= -3.14 / 2) {
-						// < 90°
-						app.Rotate(-1);
-						angleacc = 0.0;
-					}
-				}
-				//Pinch-to-zoom
-				else if (fabs(event.mgesture.dDist) > 0.002) {
-					int w, h;
-					SDL_GetWindowSize(window, &w, &h);
-					app.Zoom(event.mgesture.x * w, event.mgesture.y * h, event.mgesture.dDist * app.config.zoomFactor * 10);
+	// Background jobs wake the main loop when they have something to show
+	app.searcher.setNotify(request_frame);
+	app.m_annotations.notify = request_frame;
+
+	auto handleEvent = [&](SDL_Event &event) {
+		settle    = settleFrames;
+		lastEvent = SDL_GetTicks();
+		Renderers::current->processEvent(event);
+
+		if (event.type == SDL_DROPFILE) {
+			app.LoadFile(filesystem::u8path(event.drop.file));
+		} else if(event.type == SDL_MULTIGESTURE && event.mgesture.numFingers == 2 && !ImGui::IsMouseDown(ImGuiMouseButton_Left)) {
+			//Inhibit dragging board area
+			app.m_dragging_token = -1;
+			//Rotation detected, at least 1°
+			if (fabs(event.mgesture.dTheta) > 3.14 / 180.0) {
+				angleacc += event.mgesture.dTheta;
+				if (angleacc >= 3.14 / 2) {
+					// > 90°
+					app.Rotate(1);
+					angleacc = 0.0;
+				} else if (angleacc <= -3.14 / 2) {
+					// < 90°
+					app.Rotate(-1);
+					angleacc = 0.0;
 				}
 			}
+			//Pinch-to-zoom
+			else if (fabs(event.mgesture.dDist) > 0.002) {
+				int w, h;
+				SDL_GetWindowSize(window, &w, &h);
+				app.Zoom(event.mgesture.x * w, event.mgesture.y * h, event.mgesture.dDist * app.config.zoomFactor * 10);
+			}
+		}
+
+		if (event.type == SDL_QUIT) done = true;
+	};
 
-			if (event.type == SDL_QUIT) done = true;
+	while (!done) {
+		SDL_Event event;
+
+		// Wait for an event, or until the next tick when something is animating
+		if (settle == 0) {
+			int timeout = -1;
+			auto tick   = [&timeout](int ms) {
+				if (ms >= 0 && (timeout < 0 || ms < timeout)) timeout = ms;
+			};
+			if (SDL_GetTicks() - lastEvent < lingerMs) tick(100);
+			if (io.WantTextInput) tick(400); // text cursor blink
+			tick(app.pdfBridge.PollInterval());
+
+			bool woken = timeout < 0 ? SDL_WaitEvent(&event) : SDL_WaitEventTimeout(&event, timeout);
+			if (woken) handleEvent(event);
+		} else {
+			settle--;
 		}
 
+		// vsync disabled: render at most at the display refresh rate, waiting before reading the input rather than after
+		if (!SDL_GL_GetSwapInterval()) {
+			SDL_DisplayMode mode;
+			int hz = SDL_GetWindowDisplayMode(window, &mode) == 0 && mode.refresh_rate > 0 ? mode.refresh_rate : 60;
+			auto now = std::chrono::steady_clock::now();
+			if (now < nextFrame) std::this_thread::sleep_until(nextFrame);
+			nextFrame = std::max(now, nextFrame) + std::chrono::microseconds(1000000 / hz); // no catching up after idling
+		}
+
+		clear_frame_request();
+		while (SDL_PollEvent(&event)) handleEvent(event);
+
 		// reset rotation angle accumulator
 		if (ImGui::IsMouseDown(ImGuiMouseButton_Left)) {
 			angleacc = 0.0;
@@ -434,24 +491,21 @@ int main(int argc, char **argv) {
 			app.obvconfig.Load(configDir + "obv.conf");
 			app.ConfigParse();
 			clear_color = ImColor(app.m_colors.backgroundColor);
+			app.m_needsRedraw = true;
 		}
 
 		if (app.reloadFonts) {
 			// Needs to happen after frame has been rendered (or before starting a new frame)
 			fonts.reload(app.config.fontName);
 			app.reloadFonts = false;
+			app.m_labels.invalidate();
+			app.m_needsRedraw = true; // cached board layers refer to the old font atlas
 		}
 
-		if (!(sleepout--)) {
-#ifdef _WIN32
-			Sleep(50);
-#else
-			usleep(50000);
-#endif
-			sleepout = 0;
-			continue;
-		} // puts OBV to sleep if nothing is happening.
 		// Prepare frame
+		Trace::frameStart();
+		TraceScope trace("Frame");
+		app.profiler.beginFrame();
 		Renderers::current->initFrame();
 		ImGui::NewFrame();
 
@@ -480,20 +534,15 @@ int main(int argc, char **argv) {
 
 		// Render frame
 		ImGui::Render();
-		Renderers::current->renderFrame(clear_color);
-
-		// vsync disabled, manual FPS limiting
-		if (!SDL_GL_GetSwapInterval()) {
-			static const int FPS = 30;
-			static const std::chrono::duration<std::intmax_t, std::ratio<1, FPS>> frameDuration{1};
-			static auto nextFrame = std::chrono::steady_clock::now() + frameDuration;
-
-			std::this_thread::sleep_until(nextFrame);
-			nextFrame += frameDuration;
+		{
+			ProfileScope profile(app.profiler, Profiler::kRenderFrame);
+			Renderers::current->renderFrame(clear_color);
 		}
+		app.profiler.endFrame(ImGui::GetDrawData());
 	}
 
 	// Cleanup
+	Trace::stop(); // when closed before the traced frames were all rendered
 	Renderers::current->shutdown();
 
 	ImGui::DestroyContext();
@@ -1,6 +1,7 @@
 #include "utils.h"
 #include <SDL.h>
 #include <algorithm>
+#include <atomic>
 #include <cctype>
 #include <cstring>
 #include <fstream>
@@ -103,3 +104,16 @@ std::vector<std::string> split_string(const std::string &str, char delimeter) {
 	}
 	return strs;
 }
+
+static std::atomic<bool> frame_requested{false};
+
+void request_frame() {
+	if (frame_requested.exchange(true)) return; // the main loop has not woken up yet
+	SDL_Event event{};
+	event.type = SDL_USEREVENT;
+	SDL_PushEvent(&event);
+}
+
+void clear_frame_request() {
+	frame_requested = false;
+}
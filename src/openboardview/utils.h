@@ -37,3 +37,9 @@ std::vector<std::string> split_string(const std::string str);
 
 // Split a string in a vector with given delimiter
 std::vector<std::string> split_string(const std::string &str, char delimeter);
+
+// Wake the main loop so that it renders a frame, safe to call from any thread.
+// Requests made before the loop picks up the first one are merged in one event.
+void request_frame();
+// Called by the main loop once woken, before it looks at the state that changed
+void clear_frame_request();